@@ -0,0 +1,134 @@
+/*
+  DDX3216 Ring Modulator Plugin - DDS Oscillator
+  Direct digital synthesis carrier as on the SHARC ADSP-21160:
+  an integer phase accumulator whose top bits index precomputed
+  single-cycle tables, with linear interpolation on the remaining bits.
+  The SHARC used 32 bits; the master phase here keeps 64.
+*/
+
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+//==============================================================================
+// Carrier waveforms (matches the "waveform" parameter choice order)
+//==============================================================================
+enum class DdsWaveform { Sine, Triangle, Square };
+
+//==============================================================================
+// Single-cycle lookup tables
+//==============================================================================
+struct DdsWaveTables
+{
+    static constexpr int tableBits = 11;
+    static constexpr int tableSize = 1 << tableBits;
+    static constexpr int fracBits = 32 - tableBits;
+    static constexpr uint32_t fracMask = (1u << fracBits) - 1u;
+
+    // One guard point per table so interpolation never has to wrap
+    float sine[tableSize + 1];
+    float triangle[tableSize + 1];
+    float square[tableSize + 1];
+
+    DdsWaveTables() noexcept
+    {
+        constexpr double twoPi = 6.283185307179586476925286766559;
+
+        for (int i = 0; i <= tableSize; ++i)
+        {
+            const double t = static_cast<double>(i) / tableSize; // cycles, 0..1
+
+            sine[i] = static_cast<float>(std::sin(twoPi * t));
+
+            // Sine-phased triangle: 0 -> +1 -> -1 -> 0
+            double tri = 4.0 * t;
+            if (tri > 3.0)      tri -= 4.0;
+            else if (tri > 1.0) tri = 2.0 - tri;
+            triangle[i] = static_cast<float>(tri);
+
+            square[i] = (i % tableSize) < tableSize / 2 ? 1.0f : -1.0f;
+        }
+    }
+
+    const float* getTable(DdsWaveform waveform) const noexcept
+    {
+        switch (waveform)
+        {
+        case DdsWaveform::Triangle: return triangle;
+        case DdsWaveform::Square:   return square;
+        case DdsWaveform::Sine:
+        default:                    return sine;
+        }
+    }
+};
+
+//==============================================================================
+// Phase accumulator. The master phase is 64-bit fixed point and wraps modulo
+// 2^64 for free, so it never drifts; kernels run on its top 32 bits for one
+// block at a time and the master is advanced exactly afterwards, so rounding
+// inside a block never accumulates over long renders.
+//==============================================================================
+class DdsOscillator
+{
+public:
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        phase = 0;
+    }
+
+    void reset() noexcept { phase = 0; }
+
+    void setFrequency(double hz) noexcept
+    {
+        phaseInc = hz / sampleRate * 4294967296.0;
+    }
+
+    static uint32_t frequencyToIncrement(double hz, double sampleRate) noexcept
+    {
+        // 2^32 phase units per cycle
+        const double inc = hz / sampleRate * 4294967296.0;
+        return static_cast<uint32_t>(static_cast<int64_t>(std::llround(inc)));
+    }
+
+    // Kernel view: top 32 bits of the phase, increment rounded to 2^-32 cycles
+    uint32_t getPhase() const noexcept { return static_cast<uint32_t>(phase >> 32); }
+    uint32_t getIncrement() const noexcept { return static_cast<uint32_t>(static_cast<int64_t>(std::llround(phaseInc))); }
+    void setPhase(uint32_t newPhase) noexcept { phase = static_cast<uint64_t>(newPhase) << 32; }
+
+    // Full-resolution master phase (2^64 units per cycle)
+    uint64_t getFinePhase() const noexcept { return phase; }
+    void setFinePhase(uint64_t newPhase) noexcept { phase = newPhase; }
+
+    // Skip ahead without generating anything
+    void advance(int64_t numSamples) noexcept
+    {
+        advance(numSamples, phaseInc, 0.0);
+    }
+
+    // Exact closed form of numSamples steps with an increment (in 2^-32 cycle
+    // units, unrounded) that starts at inc and grows by incStep per sample
+    void advance(int64_t numSamples, double inc, double incStep) noexcept
+    {
+        const auto steps = static_cast<uint64_t>(numSamples);
+        const auto fineInc = static_cast<uint64_t>(std::llround(inc * 4294967296.0));
+        const auto fineStep = static_cast<uint64_t>(std::llround(incStep * 4294967296.0));
+        phase += steps * fineInc + fineStep * (steps * (steps - 1) / 2);
+    }
+
+    // Top bits select the table entry, the rest interpolate to the next one
+    template <typename SampleType = float>
+    static SampleType lookup(const float* table, uint32_t p) noexcept
+    {
+        const auto index = static_cast<int>(p >> DdsWaveTables::fracBits);
+        const auto frac = static_cast<SampleType>(p & DdsWaveTables::fracMask)
+                        * (SampleType(1) / static_cast<SampleType>(1u << DdsWaveTables::fracBits));
+        const SampleType a = table[index];
+        return a + frac * (static_cast<SampleType>(table[index + 1]) - a);
+    }
+
+private:
+    uint64_t phase = 0;
+    double phaseInc = 0.0;
+    double sampleRate = 48000.0;
+};
@@ -0,0 +1,62 @@
+/*
+  DDX3216 Ring Modulator Plugin - Parameter Ramps
+  Linear smoothing like juce::SmoothedValue, but exposing the per-sample
+  step and the number of steps left so processBlock can hand whole
+  constant-slope segments to the ramped kernels and switch back to the
+  constant-parameter kernels the moment a ramp ends.
+*/
+
+#pragma once
+
+//==============================================================================
+template <typename ValueType>
+class ParameterRamp
+{
+public:
+    void setRampLength(int numSamples) noexcept { rampLength = numSamples > 0 ? numSamples : 1; }
+
+    // Jump straight to a value (prepareToPlay, state restore)
+    void reset(ValueType value) noexcept
+    {
+        current = target = value;
+        step = ValueType();
+        remaining = 0;
+    }
+
+    void setTarget(ValueType newTarget) noexcept
+    {
+        if (newTarget == target)
+            return;
+
+        target = newTarget;
+        remaining = rampLength;
+        step = (target - current) / static_cast<ValueType>(rampLength);
+    }
+
+    bool isRamping() const noexcept { return remaining > 0; }
+    int getRemainingSamples() const noexcept { return remaining; }
+    ValueType getCurrent() const noexcept { return current; }
+    ValueType getTarget() const noexcept { return target; }
+
+    // Per-sample slope while ramping, zero otherwise
+    ValueType getStep() const noexcept { return remaining > 0 ? step : ValueType(); }
+
+    void advance(int numSamples) noexcept
+    {
+        if (numSamples >= remaining)
+        {
+            current = target;
+            remaining = 0;
+        }
+        else
+        {
+            current += step * static_cast<ValueType>(numSamples);
+            remaining -= numSamples;
+        }
+    }
+
+private:
+    ValueType current {}, target {}, step {};
+    int remaining = 0;
+    int rampLength = 1;
+};
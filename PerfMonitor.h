@@ -0,0 +1,252 @@
+/*
+  DDX3216 Ring Modulator Plugin - Real-Time Performance Monitor
+  Times every processBlock with the CPU cycle counter, keeps a histogram of
+  block load (time spent / time available) on the audio thread and hands
+  finished snapshots to other threads through a wait-free triple buffer.
+  The audio thread never locks, allocates or waits on a reader.
+*/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+ #include <intrin.h>
+ #define DDX_PERF_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+ #include <x86intrin.h>
+ #define DDX_PERF_TSC 1
+#endif
+
+//==============================================================================
+// Single-producer / single-consumer "latest value" channel. write() and
+// read() never block; the reader always sees the most recent complete value.
+//==============================================================================
+template <typename T>
+class TripleBuffer
+{
+public:
+    void write(const T& value) noexcept
+    {
+        buffers[back] = value;
+        back = middle.exchange(back | dirtyFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Returns true if a new value arrived since the last read
+    bool read(T& value) noexcept
+    {
+        const bool fresh = (middle.load(std::memory_order_relaxed) & dirtyFlag) != 0;
+
+        if (fresh)
+            front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+
+        value = buffers[front];
+        return fresh;
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int dirtyFlag = 4;
+
+    T buffers[3] {};
+    std::atomic<int> middle { 1 };
+    int back = 0;   // writer only
+    int front = 2;  // reader only
+};
+
+//==============================================================================
+// What readers get. Loads are fractions of the block's real-time budget.
+//==============================================================================
+struct PerfSnapshot
+{
+    float lastLoad = 0.0f;
+    float meanLoad = 0.0f;
+    float p50Load = 0.0f;
+    float p99Load = 0.0f;
+    float maxLoad = 0.0f;
+    double maxBlockMicroseconds = 0.0;
+    uint64_t numBlocks = 0;
+    uint64_t numOverruns = 0;
+};
+
+//==============================================================================
+class BlockPerfMonitor
+{
+public:
+    // 0.5% load per bucket up to 200%, last bucket catches everything above
+    static constexpr int numBuckets = 401;
+    static constexpr float bucketsPerUnitLoad = 200.0f;
+
+    // Call from prepareToPlay: the first call calibrates the cycle counter
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        ticksToSeconds = 1.0 / getTicksPerSecond();
+        publishInterval = static_cast<uint64_t>(sampleRate * 0.05); // ~20 snapshots a second of audio
+        resetRequested.store(true, std::memory_order_release);
+    }
+
+    // Blocks slower than this fraction of their budget count as overruns
+    void setOverrunThreshold(float loadFraction) noexcept { overrunThreshold.store(loadFraction, std::memory_order_relaxed); }
+
+    // Any thread: the histogram is cleared at the start of the next block
+    void reset() noexcept { resetRequested.store(true, std::memory_order_release); }
+
+    // Reader side. Several non-audio threads may call this; they serialise
+    // among themselves, never with the audio thread.
+    PerfSnapshot getSnapshot() noexcept
+    {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        channel.read(latest);
+        return latest;
+    }
+
+    //==============================================================================
+    // Audio thread
+    struct ScopedBlock
+    {
+        ScopedBlock(BlockPerfMonitor& m, int numSamplesToTime) noexcept
+            : monitor(m), numSamples(numSamplesToTime), start(readTicks()) {}
+
+        ~ScopedBlock() { monitor.addBlock(readTicks() - start, numSamples); }
+
+        BlockPerfMonitor& monitor;
+        const int numSamples;
+        const uint64_t start;
+    };
+
+    static uint64_t readTicks() noexcept
+    {
+       #if DDX_PERF_TSC
+        return static_cast<uint64_t>(__rdtsc());
+       #elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+       #else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+       #endif
+    }
+
+private:
+    void addBlock(uint64_t ticks, int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        if (resetRequested.exchange(false, std::memory_order_acq_rel))
+            clearHistogram();
+
+        const double seconds = static_cast<double>(ticks) * ticksToSeconds;
+        const double budget = numSamples / sampleRate;
+        const auto load = static_cast<float>(seconds / budget);
+
+        const int bucket = std::min(numBuckets - 1, static_cast<int>(load * bucketsPerUnitLoad));
+        ++histogram[bucket];
+        ++numBlocks;
+        loadSum += load;
+        lastLoad = load;
+        maxLoad = std::max(maxLoad, load);
+        maxSeconds = std::max(maxSeconds, seconds);
+
+        if (load > overrunThreshold.load(std::memory_order_relaxed))
+            ++numOverruns;
+
+        samplesSincePublish += static_cast<uint64_t>(numSamples);
+        if (samplesSincePublish >= publishInterval)
+        {
+            samplesSincePublish = 0;
+            publish();
+        }
+    }
+
+    void publish() noexcept
+    {
+        PerfSnapshot s;
+        s.lastLoad = lastLoad;
+        s.meanLoad = numBlocks > 0 ? static_cast<float>(loadSum / static_cast<double>(numBlocks)) : 0.0f;
+        s.p50Load = percentile(0.50);
+        s.p99Load = percentile(0.99);
+        s.maxLoad = maxLoad;
+        s.maxBlockMicroseconds = maxSeconds * 1.0e6;
+        s.numBlocks = numBlocks;
+        s.numOverruns = numOverruns;
+        channel.write(s);
+    }
+
+    // Upper edge of the bucket holding the requested fraction of blocks
+    float percentile(double fraction) const noexcept
+    {
+        const auto target = static_cast<uint64_t>(fraction * static_cast<double>(numBlocks));
+        uint64_t count = 0;
+
+        for (int i = 0; i < numBuckets; ++i)
+        {
+            count += histogram[i];
+            if (count > target)
+                return std::min(maxLoad, (i + 1) / bucketsPerUnitLoad);
+        }
+
+        return maxLoad;
+    }
+
+    void clearHistogram() noexcept
+    {
+        std::fill(std::begin(histogram), std::end(histogram), 0u);
+        numBlocks = numOverruns = samplesSincePublish = 0;
+        loadSum = 0.0;
+        lastLoad = maxLoad = 0.0f;
+        maxSeconds = 0.0;
+    }
+
+    // Cycle counter rate, measured once per process against steady_clock
+    static double getTicksPerSecond() noexcept
+    {
+        static const double rate = []
+        {
+           #if DDX_PERF_TSC
+            using Clock = std::chrono::steady_clock;
+            const auto t0 = Clock::now();
+            const uint64_t c0 = readTicks();
+            while (Clock::now() - t0 < std::chrono::milliseconds(5)) {}
+            const uint64_t c1 = readTicks();
+            const double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+            return static_cast<double>(c1 - c0) / elapsed;
+           #elif defined(__aarch64__)
+            uint64_t frequency;
+            asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+            return static_cast<double>(frequency);
+           #else
+            return 1.0e9;
+           #endif
+        }();
+
+        return rate;
+    }
+
+    // Audio thread state
+    uint32_t histogram[numBuckets] {};
+    uint64_t numBlocks = 0;
+    uint64_t numOverruns = 0;
+    uint64_t samplesSincePublish = 0;
+    uint64_t publishInterval = 2400;
+    double loadSum = 0.0;
+    double maxSeconds = 0.0;
+    float lastLoad = 0.0f;
+    float maxLoad = 0.0f;
+    double sampleRate = 48000.0;
+    double ticksToSeconds = 1.0e-9;
+
+    // Shared
+    std::atomic<float> overrunThreshold { 1.0f };
+    std::atomic<bool> resetRequested { false };
+    TripleBuffer<PerfSnapshot> channel;
+
+    // Reader side
+    std::mutex readerMutex;
+    PerfSnapshot latest;
+};
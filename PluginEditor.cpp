@@ -11,11 +11,14 @@
 DdxRingModAudioProcessorEditor::DdxRingModAudioProcessorEditor(DdxRingModAudioProcessor& p)
     : AudioProcessorEditor(&p), audioProcessor(p)
 {
-    setSize(700, 380);
+    // Everything is painted from an opaque cached background
+    setOpaque(true);
+    setSize(800, 590);
 
     // Setup controls
     setupControl(rateControl, "rate", "Rate", true);
     setupControl(blendControl, "blend", "Blend");
+    setupControl(spreadControl, "spread", "Spread");
 
     // Waveform combo box
     addAndMakeVisible(waveformCombo);
@@ -32,6 +35,23 @@ DdxRingModAudioProcessorEditor::DdxRingModAudioProcessorEditor(DdxRingModAudioPr
     waveformLabel.setFont(juce::FontOptions(14.0f, juce::Font::bold));
     waveformLabel.attachToComponent(&waveformCombo, false);
 
+    // Carrier bank size; the bank's own carriers are edited from the host
+    juce::StringArray carrierCounts { "1 (Single)" };
+    for (int count = 2; count <= CarrierBank::maxCarriers; ++count)
+        carrierCounts.add(juce::String(count));
+
+    setupCombo(carriersCombo, carriersLabel, "carriers", "Carriers", carrierCounts, carriersAttachment);
+    setupCombo(sourceCombo, sourceLabel, "carrierSource", "Carrier Source",
+        juce::StringArray{ "Oscillator", "Sidechain" }, sourceAttachment);
+
+    // Carrier range, realtime oversampling and SHARC emulation
+    setupCombo(rangeCombo, rangeLabel, "range", "Range",
+        juce::StringArray{ "LFO (0.5-20 Hz)", "Audio (20 Hz-5 kHz)" }, rangeAttachment);
+    setupCombo(oversamplingCombo, oversamplingLabel, "oversampling", "Oversampling",
+        juce::StringArray{ "Off", "2x", "4x", "8x" }, oversamplingAttachment);
+    setupCombo(emulationCombo, emulationLabel, "emulation", "SHARC Emulation",
+        juce::StringArray{ "Off", "SHARC 32-bit", "SHARC 40-bit" }, emulationAttachment);
+
     // Bypass button
     addAndMakeVisible(bypassButton);
     bypassButton.setButtonText("Bypass");
@@ -44,19 +64,36 @@ DdxRingModAudioProcessorEditor::DdxRingModAudioProcessorEditor(DdxRingModAudioPr
     simdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.getAPVTS(), "simd", simdButton);
 
+    // MIDI note control of the carrier
+    addAndMakeVisible(midiButton);
+    midiButton.setButtonText("MIDI Carrier");
+    midiAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getAPVTS(), "midi", midiButton);
+
+    // Input envelope driving rate and blend (its settings are host parameters)
+    addAndMakeVisible(dynamicsButton);
+    dynamicsButton.setButtonText("Dynamics");
+    dynamicsAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getAPVTS(), "dynamics", dynamicsButton);
+
     // Processing mode label
     addAndMakeVisible(processingModeLabel);
     processingModeLabel.setText("Processing Mode:", juce::dontSendNotification);
     processingModeLabel.setJustificationType(juce::Justification::centredLeft);
     processingModeLabel.setFont(juce::FontOptions(14.0f, juce::Font::bold));
 
-    // Start timer for CPU monitoring
-    startTimerHz(10);
+    // Analyzer runs only while the editor is open
+    audioProcessor.getAnalyzer().attachViewer();
+
+    // Start timer for CPU monitoring and analyzer frames
+    updateMeter();
+    startTimerHz(30);
 }
 
 DdxRingModAudioProcessorEditor::~DdxRingModAudioProcessorEditor()
 {
     stopTimer();
+    audioProcessor.getAnalyzer().detachViewer();
 }
 
 //==============================================================================
@@ -85,16 +122,95 @@ void DdxRingModAudioProcessorEditor::setupControl(ControlGroup& control,
         audioProcessor.getAPVTS(), paramID, control.slider);
 }
 
+void DdxRingModAudioProcessorEditor::setupCombo(juce::ComboBox& combo, juce::Label& label,
+    const juce::String& paramID,
+    const juce::String& labelText,
+    const juce::StringArray& items,
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>& attachment)
+{
+    addAndMakeVisible(combo);
+    combo.addItemList(items, 1);
+
+    attachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getAPVTS(), paramID, combo);
+
+    addAndMakeVisible(label);
+    label.setText(labelText, juce::dontSendNotification);
+    label.setJustificationType(juce::Justification::centred);
+    label.setFont(juce::FontOptions(14.0f, juce::Font::bold));
+    label.attachToComponent(&combo, false);
+}
+
 //==============================================================================
 void DdxRingModAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    // Static layers, re-rendered only for a new size or display scale
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (backgroundCache.isNull() || scale != backgroundScale)
+    {
+        backgroundScale = scale;
+        backgroundCache = juce::Image(juce::Image::RGB,
+            juce::jmax(1, juce::roundToInt(static_cast<float> (getWidth()) * scale)),
+            juce::jmax(1, juce::roundToInt(static_cast<float> (getHeight()) * scale)), false);
+
+        juce::Graphics cacheGraphics(backgroundCache);
+        cacheGraphics.addTransform(juce::AffineTransform::scale(scale));
+        renderBackground(cacheGraphics);
+    }
+
+    g.drawImage(backgroundCache, getLocalBounds().toFloat());
+
+    // Waveform preview
+    if (g.clipRegionIntersects(vizArea))
+    {
+        g.setColour(juce::Colours::lightgreen.withAlpha(0.8f));
+        g.strokePath(wavePath, juce::PathStrokeType(2.0f));
+    }
+
+    // Scope and spectrum
+    if (g.clipRegionIntersects(analyzerArea))
+    {
+        g.setColour(juce::Colours::lightgreen.withAlpha(0.9f));
+        g.strokePath(scopePath, juce::PathStrokeType(1.5f));
+
+        g.setColour(juce::Colours::skyblue.withAlpha(0.9f));
+        g.strokePath(spectrumPath, juce::PathStrokeType(1.5f));
+    }
+
+    // CPU meter
+    if (! g.clipRegionIntersects(meterArea))
+        return;
+
+    g.setColour(meterSimd ? juce::Colours::lightgreen : juce::Colours::orange);
+    g.setFont(juce::FontOptions(13.0f, juce::Font::bold));
+    g.drawText(meterText, meterArea, juce::Justification::centredLeft);
+
+    // Draw CPU usage bar
+    auto cpuBarArea = footerArea.reduced(15, 20).removeFromRight(200).withHeight(15);
+    g.setColour(juce::Colours::darkgrey);
+    g.fillRect(cpuBarArea);
+
+    const float cpuBarWidth = static_cast<float> (meterFillWidth) / 200.0f;
+
+    if (cpuBarWidth < 0.5f)
+        g.setColour(juce::Colours::lightgreen);
+    else if (cpuBarWidth < 0.8f)
+        g.setColour(juce::Colours::orange);
+    else
+        g.setColour(juce::Colours::red);
+
+    g.fillRect(cpuBarArea.withWidth(meterFillWidth));
+    g.setColour(juce::Colours::white.withAlpha(0.5f));
+    g.drawRect(cpuBarArea, 1);
+}
+
+void DdxRingModAudioProcessorEditor::renderBackground(juce::Graphics& g) const
 {
     // Background gradient (DDX3216 blue/grey theme)
     g.fillAll(juce::Colour(0xff2a2d3a));
 
-    auto bounds = getLocalBounds();
-
     // Header
-    auto headerArea = bounds.removeFromTop(60);
     g.setGradientFill(juce::ColourGradient(
         juce::Colour(0xff3a4a5a), 0.0f, 0.0f,
         juce::Colour(0xff2a3a4a), 0.0f, static_cast<float> (headerArea.getHeight()), false));
@@ -106,28 +222,57 @@ void DdxRingModAudioProcessorEditor::paint(juce::Graphics& g)
         juce::Justification::centred, 1);
 
     g.setFont(juce::FontOptions(12.0f));
-    g.drawFittedText("SHARC DSP Authentic Port | Stereo Ring Modulation",
+    g.drawFittedText("SHARC DSP Authentic Port | Multichannel Ring Modulation",
         headerArea.reduced(10, 35).removeFromBottom(15),
         juce::Justification::centred, 1);
 
     // Control panel background
-    auto controlArea = bounds.removeFromTop(220);
     g.setColour(juce::Colour(0xff1a1d2a));
-    g.fillRoundedRectangle(controlArea.reduced(10, 5).toFloat(), 8.0f);
-
-    // Draw waveform visualizer
-    auto vizArea = controlArea.reduced(20, 10);
-    vizArea = vizArea.withTop(vizArea.getBottom() - 80).withHeight(60);
+    g.fillRoundedRectangle(controlPanelArea.reduced(10, 5).toFloat(), 8.0f);
 
+    // Waveform visualizer background
     g.setColour(juce::Colour(0xff3a4a6a).withAlpha(0.3f));
     g.fillRoundedRectangle(vizArea.toFloat(), 4.0f);
 
-    // Draw waveform preview based on current selection
-    g.setColour(juce::Colours::lightgreen.withAlpha(0.8f));
-    juce::Path wavePath;
+    // Analyzer panels, with a centre line on the scope and 20 dB lines on
+    // the spectrum (0 to -100 dBFS)
+    g.setColour(juce::Colour(0xff1a1d2a));
+    g.fillRoundedRectangle(analyzerArea.reduced(10, 5).toFloat(), 8.0f);
+
+    g.setColour(juce::Colour(0xff3a4a6a).withAlpha(0.3f));
+    g.fillRoundedRectangle(scopeArea.toFloat(), 4.0f);
+    g.fillRoundedRectangle(spectrumArea.toFloat(), 4.0f);
+
+    g.setColour(juce::Colour(0xff4a5a6a).withAlpha(0.5f));
+    g.drawHorizontalLine(scopeArea.getCentreY(), static_cast<float> (scopeArea.getX()), static_cast<float> (scopeArea.getRight()));
+
+    for (int db = 20; db < 100; db += 20)
+        g.drawHorizontalLine(spectrumArea.getY() + spectrumArea.getHeight() * db / 100,
+            static_cast<float> (spectrumArea.getX()), static_cast<float> (spectrumArea.getRight()));
+
+    g.setColour(juce::Colours::white.withAlpha(0.5f));
+    g.setFont(juce::FontOptions(11.0f));
+    g.drawText("Scope", scopeArea.reduced(6, 4), juce::Justification::topLeft);
+    g.drawText("Spectrum", spectrumArea.reduced(6, 4), juce::Justification::topLeft);
+
+    // Footer
+    g.setColour(juce::Colour(0xff1a1d2a));
+    g.fillRect(footerArea.reduced(10, 5));
+
+    // Draw dividers
+    g.setColour(juce::Colour(0xff4a5a6a).withAlpha(0.3f));
+    g.drawLine(10.0f, 60.0f, static_cast<float> (getWidth()) - 10.0f, 60.0f, 1.0f);
+    g.drawLine(10.0f, static_cast<float> (getHeight()) - 95.0f,
+        static_cast<float> (getWidth()) - 10.0f,
+        static_cast<float> (getHeight()) - 95.0f, 1.0f);
+}
+
+void DdxRingModAudioProcessorEditor::rebuildWavePath(int waveformIdx)
+{
+    previewWaveform = waveformIdx;
+    wavePath.clear();
 
-    int waveformIdx = static_cast<int>(*audioProcessor.getAPVTS().getRawParameterValue("waveform"));
-    int numPoints = 100;
+    const int numPoints = 100;
 
     for (int i = 0; i <= numPoints; ++i)
     {
@@ -162,55 +307,104 @@ void DdxRingModAudioProcessorEditor::paint(juce::Graphics& g)
         else
             wavePath.lineTo(x, yPos);
     }
+}
 
-    g.strokePath(wavePath, juce::PathStrokeType(2.0f));
-
-    // Footer with CPU meter
-    auto footerArea = bounds;
-    g.setColour(juce::Colour(0xff1a1d2a));
-    g.fillRect(footerArea.reduced(10, 5));
+void DdxRingModAudioProcessorEditor::rebuildAnalyzerPaths()
+{
+    // Scope: the triggered window, +-1 filling the panel
+    scopePath.clear();
+    const auto& scope = analyzerFrame.scope;
+    const float scopeStep = static_cast<float> (scopeArea.getWidth()) / static_cast<float> (scope.size() - 1);
+    const float scopeHalfHeight = scopeArea.getHeight() * 0.45f;
 
-    // CPU usage meter
-    bool usingSIMD = *audioProcessor.getAPVTS().getRawParameterValue("simd") > 0.5f;
-    juce::String cpuText = juce::String("CPU: ") +
-        juce::String(currentCpuUsage * 100.0f, 1) +
-        "% | Mode: " +
-        (usingSIMD ? "SIMD (Optimized)" : "Scalar (Authentic)");
+    for (size_t i = 0; i < scope.size(); ++i)
+    {
+        const float x = scopeArea.getX() + scopeStep * static_cast<float> (i);
+        const float y = scopeArea.getCentreY() - juce::jlimit(-1.0f, 1.0f, scope[i]) * scopeHalfHeight;
 
-    g.setColour(usingSIMD ? juce::Colours::lightgreen : juce::Colours::orange);
-    g.setFont(juce::FontOptions(13.0f, juce::Font::bold));
-    g.drawText(cpuText, footerArea.reduced(15, 10), juce::Justification::centredLeft);
+        if (i == 0)
+            scopePath.startNewSubPath(x, y);
+        else
+            scopePath.lineTo(x, y);
+    }
 
-    // Draw CPU usage bar
-    auto cpuBarArea = footerArea.reduced(15, 20).removeFromRight(200).withHeight(15);
-    g.setColour(juce::Colours::darkgrey);
-    g.fillRect(cpuBarArea);
+    // Spectrum: one point per pixel column on a log axis from 20 Hz to
+    // Nyquist, 0 to -100 dBFS
+    spectrumPath.clear();
+    const double nyquist = analyzerFrame.sampleRate * 0.5;
+    const double binHz = nyquist / AnalyzerFrame::numBins;
+    const int width = juce::jmax(1, spectrumArea.getWidth());
 
-    float cpuBarWidth = juce::jlimit(0.0f, 1.0f, currentCpuUsage);
-    auto filledArea = cpuBarArea.withWidth(cpuBarArea.getWidth() * cpuBarWidth);
+    for (int px = 0; px <= width; ++px)
+    {
+        const double hz = 20.0 * std::pow(nyquist / 20.0, static_cast<double>(px) / width);
+        const int bin = juce::jlimit(1, AnalyzerFrame::numBins - 1, static_cast<int>(hz / binHz));
+        const float db = juce::jlimit(-100.0f, 0.0f, analyzerFrame.spectrumDb[static_cast<size_t>(bin)]);
 
-    if (cpuBarWidth < 0.5f)
-        g.setColour(juce::Colours::lightgreen);
-    else if (cpuBarWidth < 0.8f)
-        g.setColour(juce::Colours::orange);
-    else
-        g.setColour(juce::Colours::red);
+        const float x = static_cast<float> (spectrumArea.getX() + px);
+        const float y = spectrumArea.getY() - db / 100.0f * static_cast<float> (spectrumArea.getHeight());
 
-    g.fillRect(filledArea);
-    g.setColour(juce::Colours::white.withAlpha(0.5f));
-    g.drawRect(cpuBarArea, 1);
+        if (px == 0)
+            spectrumPath.startNewSubPath(x, y);
+        else
+            spectrumPath.lineTo(x, y);
+    }
+}
 
-    // Draw dividers
-    g.setColour(juce::Colour(0xff4a5a6a).withAlpha(0.3f));
-    g.drawLine(10.0f, 60.0f, static_cast<float> (getWidth()) - 10.0f, 60.0f, 1.0f);
-    g.drawLine(10.0f, static_cast<float> (getHeight()) - 95.0f,
-        static_cast<float> (getWidth()) - 10.0f,
-        static_cast<float> (getHeight()) - 95.0f, 1.0f);
+bool DdxRingModAudioProcessorEditor::updateMeter()
+{
+    // Emulation takes over from either path while it is on
+    const int emulation = static_cast<int>(*audioProcessor.getAPVTS().getRawParameterValue("emulation"));
+    const bool usingSIMD = emulation == 0 && *audioProcessor.getAPVTS().getRawParameterValue("simd") > 0.5f;
+    const juce::String mode = emulation == 1 ? juce::String("SHARC 32-bit (Emulated)")
+                            : emulation == 2 ? juce::String("SHARC 40-bit (Emulated)")
+                            : usingSIMD ? "SIMD (" + audioProcessor.getSimdKernelName() + ")"
+                                        : juce::String("Scalar (Authentic)");
+    const juce::String text = juce::String("CPU: ") +
+        juce::String(perfSnapshot.meanLoad * 100.0f, 1) +
+        "% (p99 " + juce::String(perfSnapshot.p99Load * 100.0f, 1) +
+        "%, max " + juce::String(perfSnapshot.maxLoad * 100.0f, 1) +
+        "%, " + juce::String(static_cast<juce::int64>(perfSnapshot.numOverruns)) +
+        " overruns) | Mode: " + mode;
+
+    // Bar fill in whole pixels
+    const int fillWidth = juce::roundToInt(200.0f * juce::jlimit(0.0f, 1.0f, perfSnapshot.p99Load));
+
+    if (text == meterText && fillWidth == meterFillWidth && usingSIMD == meterSimd)
+        return false;
+
+    meterText = text;
+    meterFillWidth = fillWidth;
+    meterSimd = usingSIMD;
+    return true;
 }
 
 //==============================================================================
 void DdxRingModAudioProcessorEditor::resized()
 {
+    // Painted regions; the cached layers are redrawn for the new size
+    {
+        auto area = getLocalBounds();
+        headerArea = area.removeFromTop(60);
+        controlPanelArea = area.removeFromTop(290);
+        analyzerArea = area.removeFromTop(140);
+        footerArea = area;
+
+        auto panels = analyzerArea.reduced(20, 15);
+        scopeArea = panels.removeFromLeft((panels.getWidth() - 10) / 2);
+        spectrumArea = panels.withTrimmedLeft(10);
+
+        // Waveform preview in its own strip under the controls, clear of
+        // the knobs' text boxes and the stacked combos
+        vizArea = controlPanelArea.reduced(20, 10);
+        vizArea = vizArea.withTop(vizArea.getBottom() - 80).withHeight(60);
+        meterArea = footerArea.reduced(15, 10);
+    }
+
+    backgroundCache = {};
+    rebuildWavePath(static_cast<int>(*audioProcessor.getAPVTS().getRawParameterValue("waveform")));
+    rebuildAnalyzerPaths();
+
     auto bounds = getLocalBounds();
     bounds.removeFromTop(65); // Skip header
 
@@ -231,32 +425,86 @@ void DdxRingModAudioProcessorEditor::resized()
         blendControl.slider.getY() - 25,
         sliderWidth, 20);
 
+    controlArea.removeFromLeft(spacing);
+
+    spreadControl.slider.setBounds(controlArea.removeFromLeft(sliderWidth));
+    spreadControl.label.setBounds(spreadControl.slider.getX(),
+        spreadControl.slider.getY() - 25,
+        sliderWidth, 20);
+
     controlArea.removeFromLeft(spacing * 3);
 
-    // Waveform selector
-    waveformCombo.setBounds(controlArea.removeFromLeft(180).withHeight(30));
+    // Waveform selector, carrier count and source below it
+    auto waveArea = controlArea.removeFromLeft(180);
+    waveformCombo.setBounds(waveArea.removeFromTop(30));
     waveformLabel.setBounds(waveformCombo.getX(),
         waveformCombo.getY() - 25,
         180, 20);
 
+    waveArea.removeFromTop(30);
+    carriersCombo.setBounds(waveArea.removeFromTop(30));
+    carriersLabel.setBounds(carriersCombo.getX(), carriersCombo.getY() - 25, 180, 20);
+
+    waveArea.removeFromTop(30);
+    sourceCombo.setBounds(waveArea.removeFromTop(30));
+    sourceLabel.setBounds(sourceCombo.getX(), sourceCombo.getY() - 25, 180, 20);
+
+    // Range, oversampling and emulation stacked beside it
+    controlArea.removeFromLeft(spacing);
+    auto optionsArea = controlArea.removeFromLeft(160);
+    rangeCombo.setBounds(optionsArea.removeFromTop(30));
+    rangeLabel.setBounds(rangeCombo.getX(), rangeCombo.getY() - 25, 160, 20);
+
+    optionsArea.removeFromTop(30);
+    oversamplingCombo.setBounds(optionsArea.removeFromTop(30));
+    oversamplingLabel.setBounds(oversamplingCombo.getX(), oversamplingCombo.getY() - 25, 160, 20);
+
+    optionsArea.removeFromTop(30);
+    emulationCombo.setBounds(optionsArea.removeFromTop(30));
+    emulationLabel.setBounds(emulationCombo.getX(), emulationCombo.getY() - 25, 160, 20);
+
+    // Preview and analyzer strips are painted, not components
+    bounds.removeFromTop(70);
+    bounds.removeFromTop(140);
+
     // Footer controls
-    auto footerArea = bounds.removeFromTop(80).reduced(20, 10);
+    auto footerControls = bounds.removeFromTop(80).reduced(20, 10);
 
-    processingModeLabel.setBounds(footerArea.removeFromTop(25));
+    processingModeLabel.setBounds(footerControls.removeFromTop(25));
 
-    auto buttonArea = footerArea.removeFromTop(30);
+    auto buttonArea = footerControls.removeFromTop(30);
     bypassButton.setBounds(buttonArea.removeFromLeft(120));
     buttonArea.removeFromLeft(20);
     simdButton.setBounds(buttonArea.removeFromLeft(200));
+    buttonArea.removeFromLeft(20);
+    midiButton.setBounds(buttonArea.removeFromLeft(140));
+    buttonArea.removeFromLeft(20);
+    dynamicsButton.setBounds(buttonArea.removeFromLeft(120));
 }
 
 //==============================================================================
 void DdxRingModAudioProcessorEditor::timerCallback()
 {
-    // Update CPU usage display
-    currentCpuUsage = audioProcessor.getCpuUsage();
+    // Update CPU usage display, repainting only the meter and only when the
+    // reading it shows has changed
+    perfSnapshot = audioProcessor.getPerformanceSnapshot();
 
-    // Only repaint footer area (CPU meter) and waveform visualizer
-    repaint(0, getHeight() - 95, getWidth(), 95);
-    repaint(getWidth() - 300, 140, 280, 60); // Waveform visualizer area
+    if (updateMeter())
+        repaint(meterArea);
+
+    // New analyzer frame
+    if (audioProcessor.getAnalyzer().getLatestFrame(analyzerFrame))
+    {
+        rebuildAnalyzerPaths();
+        repaint(analyzerArea);
+    }
+
+    // Waveform preview follows the parameter
+    const int waveformIdx = static_cast<int>(*audioProcessor.getAPVTS().getRawParameterValue("waveform"));
+
+    if (waveformIdx != previewWaveform)
+    {
+        rebuildWavePath(waveformIdx);
+        repaint(vizArea);
+    }
 }
\ No newline at end of file
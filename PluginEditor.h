@@ -32,23 +32,76 @@ private:
 
     ControlGroup rateControl;
     ControlGroup blendControl;
+    ControlGroup spreadControl;
 
     juce::ComboBox waveformCombo;
     juce::Label waveformLabel;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> waveformAttachment;
 
+    juce::ComboBox carriersCombo;
+    juce::Label carriersLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> carriersAttachment;
+
+    juce::ComboBox sourceCombo;
+    juce::Label sourceLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> sourceAttachment;
+
+    juce::ComboBox rangeCombo;
+    juce::Label rangeLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> rangeAttachment;
+
+    juce::ComboBox oversamplingCombo;
+    juce::Label oversamplingLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
+
+    juce::ComboBox emulationCombo;
+    juce::Label emulationLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> emulationAttachment;
+
     juce::ToggleButton bypassButton;
     juce::ToggleButton simdButton;
+    juce::ToggleButton midiButton;
+    juce::ToggleButton dynamicsButton;
     juce::Label processingModeLabel;
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> bypassAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> simdAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> midiAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> dynamicsAttachment;
 
     // CPU meter
-    float currentCpuUsage = 0.0f;
+    PerfSnapshot perfSnapshot;
+
+    // Static layers (backgrounds, header, panels) rendered once per size and
+    // display scale; the preview path rebuilt only when the waveform changes
+    juce::Image backgroundCache;
+    float backgroundScale = 0.0f;
+    juce::Path wavePath;
+    int previewWaveform = -1;
+
+    // Regions paint() draws into, worked out in resized()
+    juce::Rectangle<int> headerArea, controlPanelArea, footerArea, vizArea, meterArea;
+    juce::Rectangle<int> analyzerArea, scopeArea, spectrumArea;
+
+    // Latest analyzer frame as paths; rebuilt only when a new frame arrives
+    AnalyzerFrame analyzerFrame;
+    juce::Path scopePath, spectrumPath;
+
+    // What the meter shows now, so an unchanged reading doesn't repaint
+    juce::String meterText;
+    int meterFillWidth = -1;
+    bool meterSimd = false;
+
+    void renderBackground(juce::Graphics& g) const;
+    void rebuildWavePath(int waveformIdx);
+    void rebuildAnalyzerPaths();
+    bool updateMeter();
 
     void setupControl(ControlGroup& control, const juce::String& paramID,
         const juce::String& labelText, bool isFrequency = false);
+    void setupCombo(juce::ComboBox& combo, juce::Label& label, const juce::String& paramID,
+        const juce::String& labelText, const juce::StringArray& items,
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>& attachment);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DdxRingModAudioProcessorEditor)
 };
\ No newline at end of file
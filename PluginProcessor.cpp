@@ -11,12 +11,65 @@
 DdxRingModAudioProcessor::DdxRingModAudioProcessor()
     : AudioProcessor(BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
-        .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+        .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+        .withInput("Sidechain", juce::AudioChannelSet::stereo(), false)),
     apvts(*this, nullptr, "PARAMS", createParameterLayout())
 {
+    paramHandles.rate = apvts.getRawParameterValue("rate");
+    paramHandles.blend = apvts.getRawParameterValue("blend");
+    paramHandles.waveform = apvts.getRawParameterValue("waveform");
+    paramHandles.bypass = apvts.getRawParameterValue("bypass");
+    paramHandles.simd = apvts.getRawParameterValue("simd");
+    paramHandles.range = apvts.getRawParameterValue("range");
+    paramHandles.oversampling = apvts.getRawParameterValue("oversampling");
+    paramHandles.renderOversampling = apvts.getRawParameterValue("renderOversampling");
+    paramHandles.spread = apvts.getRawParameterValue("spread");
+    paramHandles.carriers = apvts.getRawParameterValue("carriers");
+    paramHandles.midi = apvts.getRawParameterValue("midi");
+    paramHandles.glide = apvts.getRawParameterValue("glide");
+    paramHandles.bendRange = apvts.getRawParameterValue("bendRange");
+    paramHandles.carrierSource = apvts.getRawParameterValue("carrierSource");
+    paramHandles.dynamics = apvts.getRawParameterValue("dynamics");
+    paramHandles.envAttack = apvts.getRawParameterValue("envAttack");
+    paramHandles.envRelease = apvts.getRawParameterValue("envRelease");
+    paramHandles.envRange = apvts.getRawParameterValue("envRange");
+    paramHandles.envToRate = apvts.getRawParameterValue("envToRate");
+    paramHandles.envToBlend = apvts.getRawParameterValue("envToBlend");
+    paramHandles.emulation = apvts.getRawParameterValue("emulation");
+
+    for (int c = 0; c < ParameterSnapshot::numExtraCarriers; ++c)
+    {
+        auto& handles = paramHandles.extraCarriers[static_cast<size_t>(c)];
+        handles.ratio = apvts.getRawParameterValue(ParameterSnapshot::getCarrierParameterId(c + 2, 0));
+        handles.detune = apvts.getRawParameterValue(ParameterSnapshot::getCarrierParameterId(c + 2, 1));
+        handles.waveform = apvts.getRawParameterValue(ParameterSnapshot::getCarrierParameterId(c + 2, 2));
+        handles.level = apvts.getRawParameterValue(ParameterSnapshot::getCarrierParameterId(c + 2, 3));
+    }
+
+    for (size_t i = 0; i < snapshotParameters.size(); ++i)
+    {
+        const auto id = ParameterSnapshot::getParameterId(static_cast<int>(i));
+        snapshotParameters[i] = apvts.getParameter(id);
+        snapshotValues[i] = apvts.getRawParameterValue(id);
+        jassert(snapshotParameters[i] != nullptr);
+    }
+
+    addFactoryPresets();
+
+    // Usable until the host calls prepareToPlay with its real block size
+    engine.setSettings(readSettings());
+    engine.prepare(48000.0, 512, 2, 2, true);
+    engine.prepare(48000.0, 512, 2, 2, false);
+    blockChannels.resize(2);
+    blockChannelsDouble.resize(2);
+
+    startTimerHz(20);
 }
 
-DdxRingModAudioProcessor::~DdxRingModAudioProcessor() {}
+DdxRingModAudioProcessor::~DdxRingModAudioProcessor()
+{
+    stopTimer();
+}
 
 //==============================================================================
 juce::AudioProcessorValueTreeState::ParameterLayout DdxRingModAudioProcessor::createParameterLayout()
@@ -45,213 +98,492 @@ juce::AudioProcessorValueTreeState::ParameterLayout DdxRingModAudioProcessor::cr
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         "simd", "Use SIMD (Low CPU)", false));
 
+    // Carrier range: the original LFO sweep, or audio-rate ring modulation
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "range", "Range",
+        juce::StringArray{ "LFO (0.5-20 Hz)", "Audio (20 Hz-5 kHz)" }, 0));
+
+    // Oversampling for realtime playback, and for offline renders
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "oversampling", "Oversampling",
+        juce::StringArray{ "Off", "2x", "4x", "8x" }, 0));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "renderOversampling", "Render Oversampling",
+        juce::StringArray{ "Same as Realtime", "Off", "2x", "4x", "8x" }, 0));
+
+    // Spread: 0-1 fans the carrier phase out across the output channels
+    // (1 = evenly around the cycle, so stereo gets opposite carriers)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "spread", "Spread",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
+
+    // Carrier bank: 1 is the classic single carrier. Above that, carriers
+    // 2-16 join the main one, each at its own ratio of the main rate,
+    // detune, shape and level, and the sum modulates the input.
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "carriers", "Carriers", 1, CarrierBank::maxCarriers, 1));
+
+    for (int carrier = 2; carrier <= CarrierBank::maxCarriers; ++carrier)
+    {
+        const auto name = "Carrier " + juce::String(carrier) + " ";
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            ParameterSnapshot::getCarrierParameterId(carrier, 0), name + "Ratio",
+            juce::NormalisableRange<float>(0.1f, 16.0f, 0.001f, 0.4f), static_cast<float>(carrier)));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            ParameterSnapshot::getCarrierParameterId(carrier, 1), name + "Detune",
+            juce::NormalisableRange<float>(-100.0f, 100.0f, 0.1f), 0.0f,
+            juce::AudioParameterFloatAttributes().withLabel("ct")));
+
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            ParameterSnapshot::getCarrierParameterId(carrier, 2), name + "Waveform",
+            juce::StringArray{ "Sine", "Triangle", "Square" }, 0));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            ParameterSnapshot::getCarrierParameterId(carrier, 3), name + "Level",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f));
+    }
+
+    // MIDI carrier: notes set the carrier frequency (the rate knob takes
+    // over again only when this is switched off), gliding between notes
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "midi", "MIDI Carrier", false));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "glide", "Glide",
+        juce::NormalisableRange<float>(0.0f, 2000.0f, 1.0f, 0.3f), 50.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms")));
+
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "bendRange", "Bend Range", 0, 24, 2,
+        juce::AudioParameterIntAttributes().withLabel("st")));
+
+    // Carrier source: the oscillator, or the sidechain input multiplied in
+    // directly, as on an analog ring modulator
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "carrierSource", "Carrier Source",
+        juce::StringArray{ "Oscillator", "Sidechain" }, 0));
+
+    // Dynamics: an envelope follower on the input pushes the carrier rate
+    // (in octaves) and the blend as the input gets louder. The range is
+    // how far below full scale the envelope starts to count; the blend
+    // amount takes it down from the blend setting for quiet (positive)
+    // or loud (negative) input. Oscillator carrier only.
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "dynamics", "Dynamics", false));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "envAttack", "Env Attack",
+        juce::NormalisableRange<float>(0.1f, 200.0f, 0.1f, 0.4f), 5.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms")));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "envRelease", "Env Release",
+        juce::NormalisableRange<float>(5.0f, 2000.0f, 1.0f, 0.4f), 150.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms")));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "envRange", "Env Range",
+        juce::NormalisableRange<float>(12.0f, 96.0f, 1.0f), 48.0f,
+        juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "envToRate", "Env > Rate",
+        juce::NormalisableRange<float>(-4.0f, 4.0f, 0.01f), 1.0f,
+        juce::AudioParameterFloatAttributes().withLabel("oct")));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "envToBlend", "Env > Blend",
+        juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f), 0.5f));
+
+    // SHARC emulation: the authentic tables in the ADSP-21160's own
+    // arithmetic, at its 32-bit float or 40-bit extended precision
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "emulation", "SHARC Emulation",
+        juce::StringArray{ "Off", "SHARC 32-bit", "SHARC 40-bit" }, 0));
+
     return { params.begin(), params.end() };
 }
 
 //==============================================================================
-float DdxRingModAudioProcessor::sineWave(float t) const noexcept
+int DdxRingModAudioProcessor::getWantedOversamplingStages() const noexcept
 {
-    return std::sin(t);
+    const auto realtime = static_cast<int>(paramHandles.oversampling->load(std::memory_order_relaxed));
+    const auto render = static_cast<int>(paramHandles.renderOversampling->load(std::memory_order_relaxed));
+
+    // "Same as Realtime" is choice 0; the rest are off, 2x, 4x, 8x
+    return isNonRealtime() && render > 0 ? render - 1 : realtime;
 }
 
-float DdxRingModAudioProcessor::triangleWave(float t) const noexcept
+void DdxRingModAudioProcessor::timerCallback()
 {
-    // Fast triangle wave approximation
-    float modt = std::fmod(t, juce::MathConstants<float>::twoPi);
-    float val = 2.0f * modt / juce::MathConstants<float>::pi;
-    if (val > 1.0f) val = 2.0f - val;
-    if (val < -1.0f) val = -2.0f - val;
-    return val;
+    if (const int latency = pendingLatency.load(); latency != getLatencySamples())
+        setLatencySamples(latency);
+
+    // A preset the audio thread switched to; bring the parameters in line
+    if (auto* preset = appliedPreset.exchange(nullptr))
+        catchUpParameters(*preset);
+
+    // Posted a tick ago and still not taken: no blocks are coming, so it
+    // is applied here instead
+    auto* waiting = waitingPreset;
+    if (waiting != nullptr && pendingPreset.compare_exchange_strong(waiting, nullptr, std::memory_order_acquire))
+        setParameters(*waiting, true);
+
+    waitingPreset = pendingPreset.load(std::memory_order_acquire);
 }
 
-float DdxRingModAudioProcessor::squareWave(float t) const noexcept
+//==============================================================================
+void DdxRingModAudioProcessor::addFactoryPresets()
 {
-    return std::sin(t) >= 0.0f ? 1.0f : -1.0f;
+    // Extra bank carriers: ratio, detune (cents), shape, level
+    struct ExtraCarrier
+    {
+        float ratio, detune, waveform, level;
+    };
+
+    // Struck-bell partials with a hum tone below, and a detuned cluster of
+    // square-root ratios mixing sines and squares
+    static constexpr ExtraCarrier bell[] = {
+        { 2.756f, 0.0f, 0.0f, 0.7f }, { 5.404f, 0.0f, 0.0f, 0.5f }, { 8.933f, 0.0f, 0.0f, 0.35f },
+        { 13.344f, 0.0f, 0.0f, 0.25f }, { 0.5f, 0.0f, 0.0f, 0.4f }
+    };
+
+    static constexpr ExtraCarrier cluster[] = {
+        { 1.414f, 7.0f, 0.0f, 0.5f }, { 1.732f, -7.0f, 2.0f, 0.5f }, { 2.236f, 7.0f, 2.0f, 0.5f },
+        { 2.645f, -7.0f, 0.0f, 0.5f }, { 3.162f, 7.0f, 2.0f, 0.5f }, { 3.605f, -7.0f, 2.0f, 0.5f },
+        { 4.123f, 7.0f, 0.0f, 0.5f }
+    };
+
+    struct FactoryPreset
+    {
+        const char* name;
+        float rate, blend, waveform, range, oversampling, spread;
+        const ExtraCarrier* extra;
+        int numExtra;
+    };
+
+    static constexpr FactoryPreset factory[] = {
+        { "Init",               0.3f,  0.5f, 0.0f, 0.0f, 0.0f, 0.0f, nullptr, 0 },
+        { "Slow Sine Tremolo",  0.05f, 0.6f, 0.0f, 0.0f, 0.0f, 0.0f, nullptr, 0 },
+        { "Triangle Wobble",    0.4f,  0.7f, 1.0f, 0.0f, 0.0f, 0.0f, nullptr, 0 },
+        { "Square Chop",        0.6f,  1.0f, 2.0f, 0.0f, 0.0f, 0.0f, nullptr, 0 },
+        { "Bell Ring",          0.55f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, nullptr, 0 },
+        { "Wide Stereo Ring",   0.4f,  0.8f, 0.0f, 1.0f, 1.0f, 1.0f, nullptr, 0 },
+        { "Inharmonic Bell",    0.45f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, bell, static_cast<int>(std::size(bell)) },
+        { "Metal Cluster",      0.6f,  0.9f, 0.0f, 1.0f, 1.0f, 0.0f, cluster, static_cast<int>(std::size(cluster)) }
+    };
+
+    // Session-only parameters keep their defaults; presets never apply them
+    const auto defaults = captureParameters();
+
+    for (int i = 0; i < static_cast<int>(std::size(factory)); ++i)
+    {
+        const auto& preset = factory[i];
+        auto snapshot = defaults;
+
+        auto set = [&snapshot](const juce::String& id, float value)
+        {
+            for (int p = 0; p < ParameterSnapshot::numParameters; ++p)
+                if (ParameterSnapshot::getParameterId(p) == id)
+                    snapshot.values[static_cast<size_t>(p)] = value;
+        };
+
+        set("rate", preset.rate);
+        set("blend", preset.blend);
+        set("waveform", preset.waveform);
+        set("range", preset.range);
+        set("oversampling", preset.oversampling);
+        set("spread", preset.spread);
+        set("carriers", static_cast<float>(1 + preset.numExtra));
+
+        for (int c = 0; c < preset.numExtra; ++c)
+        {
+            const auto& carrier = preset.extra[c];
+            set(ParameterSnapshot::getCarrierParameterId(c + 2, 0), carrier.ratio);
+            set(ParameterSnapshot::getCarrierParameterId(c + 2, 1), carrier.detune);
+            set(ParameterSnapshot::getCarrierParameterId(c + 2, 2), carrier.waveform);
+            set(ParameterSnapshot::getCarrierParameterId(c + 2, 3), carrier.level);
+        }
+
+        presetBank.setPreset(i, preset.name, snapshot);
+    }
 }
 
-//==============================================================================
-void DdxRingModAudioProcessor::prepareToPlay(double sampleRate, int /*samplesPerBlock*/)
+void DdxRingModAudioProcessor::storePreset(int index, const juce::String& name)
 {
-    currentSampleRate = sampleRate;
-    phase = 0.0f;
+    presetBank.setPreset(index, name, captureParameters());
 }
 
-//==============================================================================
-void DdxRingModAudioProcessor::releaseResources() {}
+void DdxRingModAudioProcessor::setCurrentProgram(int index)
+{
+    if (auto* preset = presetBank.get(index))
+    {
+        currentProgram.store(index);
+
+        // On the message thread the parameters can simply be set, which the
+        // state and editor see at once. A preset posted earlier is dropped,
+        // so it can't land over this one later.
+        if (juce::MessageManager::existsAndIsCurrentThread())
+        {
+            pendingPreset.store(nullptr, std::memory_order_release);
+            setParameters(*preset, true);
+            return;
+        }
+
+        // Elsewhere only a pointer changes hands; the snapshot itself was
+        // built up front
+        pendingPreset.store(preset, std::memory_order_release);
+    }
+}
+
+ParameterSnapshot DdxRingModAudioProcessor::captureParameters() const noexcept
+{
+    ParameterSnapshot snapshot;
+
+    for (size_t i = 0; i < snapshotValues.size(); ++i)
+        snapshot.values[i] = snapshotValues[i]->load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+void DdxRingModAudioProcessor::setParameters(const ParameterSnapshot& snapshot, bool presetOnly)
+{
+    for (size_t i = 0; i < snapshotParameters.size(); ++i)
+    {
+        if (presetOnly && ! ParameterSnapshot::isInPresets(static_cast<int>(i)))
+            continue;
+
+        auto* param = snapshotParameters[i];
+        const float normalised = param->convertTo0to1(snapshot.values[i]);
+
+        if (param->getValue() != normalised)
+            param->setValueNotifyingHost(normalised);
+    }
+}
+
+void DdxRingModAudioProcessor::catchUpParameters(const ParameterSnapshot& preset)
+{
+    for (size_t i = 0; i < snapshotParameters.size(); ++i)
+    {
+        if (! ParameterSnapshot::isInPresets(static_cast<int>(i)))
+            continue;
+
+        // A raw value that no longer matches the preset was changed after
+        // the switch; that change stands
+        if (snapshotValues[i]->load(std::memory_order_relaxed) != preset.values[i])
+            continue;
+
+        auto* param = snapshotParameters[i];
+        const float normalised = param->convertTo0to1(preset.values[i]);
+
+        if (param->getValue() != normalised)
+            param->setValueNotifyingHost(normalised);
+    }
+}
+
+RingModSettings DdxRingModAudioProcessor::readSettings() const noexcept
+{
+    auto value = [](const std::atomic<float>* handle) { return handle->load(std::memory_order_relaxed); };
+
+    RingModSettings settings;
+    settings.rate = value(paramHandles.rate);
+    settings.blend = value(paramHandles.blend);
+    settings.waveform = static_cast<DdsWaveform>(static_cast<int>(value(paramHandles.waveform)));
+    settings.bypass = value(paramHandles.bypass) > 0.5f;
+    settings.simd = value(paramHandles.simd) > 0.5f;
+    settings.audioRange = value(paramHandles.range) > 0.5f;
+    settings.oversamplingStages = getWantedOversamplingStages();
+    settings.spread = value(paramHandles.spread);
+
+    settings.numCarriers = juce::roundToInt(value(paramHandles.carriers));
+
+    for (size_t c = 0; c < settings.extraCarriers.size(); ++c)
+    {
+        const auto& handles = paramHandles.extraCarriers[c];
+        auto& carrier = settings.extraCarriers[c];
+        carrier.ratio = value(handles.ratio);
+        carrier.detune = value(handles.detune);
+        carrier.waveform = static_cast<DdsWaveform>(static_cast<int>(value(handles.waveform)));
+        carrier.level = value(handles.level);
+    }
+
+    settings.midi = value(paramHandles.midi) > 0.5f;
+    settings.glideMs = value(paramHandles.glide);
+    settings.bendRange = value(paramHandles.bendRange);
+    settings.sidechain = value(paramHandles.carrierSource) > 0.5f;
+
+    settings.dynamics = value(paramHandles.dynamics) > 0.5f;
+    settings.envAttackMs = value(paramHandles.envAttack);
+    settings.envReleaseMs = value(paramHandles.envRelease);
+    settings.envRangeDb = value(paramHandles.envRange);
+    settings.envToRate = value(paramHandles.envToRate);
+    settings.envToBlend = value(paramHandles.envToBlend);
+
+    settings.emulation = static_cast<int>(value(paramHandles.emulation));
+    return settings;
+}
+
+void DdxRingModAudioProcessor::seekTo(int64_t samplePosition)
+{
+    engine.setSettings(readSettings());
+    engine.seekTo(samplePosition);
+}
 
 //==============================================================================
-bool DdxRingModAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+void DdxRingModAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
+    perfMonitor.prepare(sampleRate);
+    analyzer.prepare(sampleRate);
 
-    if (layouts.getMainInputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainInputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
+    // The sidechain is mono or as wide as the main output
+    engine.setSettings(readSettings());
+    engine.prepare(sampleRate, samplesPerBlock,
+                   juce::jmax(getMainBusNumInputChannels(), getMainBusNumOutputChannels()),
+                   juce::jmax(getChannelCountOfBus(true, 1), 1), isUsingDoublePrecision());
+
+    const int bufferChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels());
+    blockChannels.resize(static_cast<size_t>(bufferChannels));
+    blockChannelsDouble.resize(static_cast<size_t>(bufferChannels));
 
-    return true;
+    pendingLatency = engine.getLatencySamples();
+    setLatencySamples(pendingLatency.load());
 }
 
 //==============================================================================
-void DdxRingModAudioProcessor::processBlockScalar(juce::AudioBuffer<float>& buffer, float blend)
+void DdxRingModAudioProcessor::releaseResources() {}
+
+//==============================================================================
+bool DdxRingModAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    auto numSamples = buffer.getNumSamples();
-    auto numChannels = buffer.getNumChannels();
+    const auto& input = layouts.getMainInputChannelSet();
+    const auto& output = layouts.getMainOutputChannelSet();
 
-    // Process each channel
-    for (int channel = 0; channel < numChannels; ++channel)
+    if (output.isDisabled())
+        return false;
+
+    // Sidechain: off, mono, or matching the main output
+    if (layouts.inputBuses.size() > 1)
     {
-        auto* data = buffer.getWritePointer(channel);
-        float localPhase = phase;
+        const auto& sidechain = layouts.getChannelSet(true, 1);
 
-        for (int i = 0; i < numSamples; ++i)
-        {
-            // Calculate modulator value based on waveform
-            float modulator = 0.0f;
-            switch (currentWaveform)
-            {
-            case Waveform::Sine:
-                modulator = sineWave(localPhase);
-                break;
-            case Waveform::Triangle:
-                modulator = triangleWave(localPhase);
-                break;
-            case Waveform::Square:
-                modulator = squareWave(localPhase);
-                break;
-            }
+        if (! sidechain.isDisabled() && sidechain != juce::AudioChannelSet::mono() && sidechain != output)
+            return false;
+    }
 
-            // Ring modulation: input * modulator
-            data[i] = (1.0f - blend) * data[i] + blend * modulator * data[i];
+    // Mono in, stereo out
+    if (input == juce::AudioChannelSet::mono() && output == juce::AudioChannelSet::stereo())
+        return true;
 
-            // Update phase
-            localPhase += phaseInc;
-            if (localPhase >= juce::MathConstants<float>::twoPi)
-                localPhase -= juce::MathConstants<float>::twoPi;
-        }
-    }
+    // Otherwise any layout (surround, ambisonic, discrete), the same both sides
+    return input == output;
+}
 
-    // Update global phase for next block
-    phase += static_cast<float>(numSamples) * phaseInc;
-    while (phase >= juce::MathConstants<float>::twoPi)
-        phase -= juce::MathConstants<float>::twoPi;
+//==============================================================================
+void DdxRingModAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+{
+    process(buffer, midi);
 }
 
-void DdxRingModAudioProcessor::processBlockSIMD(juce::AudioBuffer<float>& buffer, float blend)
+void DdxRingModAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midi)
 {
-    using SIMD = juce::dsp::SIMDRegister<float>;
-    constexpr size_t simdWidth = SIMD::SIMDRegisterSize;
+    process(buffer, midi);
+}
+
+template <typename SampleType>
+void DdxRingModAudioProcessor::process(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midi)
+{
+    juce::ScopedNoDenormals noDenormals;
 
     auto numSamples = buffer.getNumSamples();
-    auto numChannels = buffer.getNumChannels();
 
-    for (int channel = 0; channel < numChannels; ++channel)
-    {
-        auto* data = buffer.getWritePointer(channel);
-        float localPhase = phase;
-        size_t vectorSamples = (static_cast<size_t>(numSamples) / simdWidth) * simdWidth;
+    // CPU monitoring (covers every exit path, bypass included)
+    BlockPerfMonitor::ScopedBlock blockTimer(perfMonitor, numSamples);
 
-        // SIMD main loop
-        for (size_t i = 0; i < vectorSamples; i += simdWidth)
-        {
-            // Generate SIMD modulator values
-            alignas(32) float modVals[simdWidth];
-            for (size_t j = 0; j < simdWidth; ++j)
-            {
-                float t = localPhase + static_cast<float>(j) * phaseInc;
-                switch (currentWaveform)
-                {
-                case Waveform::Sine:
-                    modVals[j] = sineWave(t);
-                    break;
-                case Waveform::Triangle:
-                    modVals[j] = triangleWave(t);
-                    break;
-                case Waveform::Square:
-                    modVals[j] = squareWave(t);
-                    break;
-                }
-            }
+    // Preset switch: every value lands in this block together; the
+    // parameters themselves catch up from the message thread
+    if (auto* preset = pendingPreset.exchange(nullptr, std::memory_order_acquire))
+    {
+        for (size_t i = 0; i < snapshotValues.size(); ++i)
+            if (ParameterSnapshot::isInPresets(static_cast<int>(i)))
+                snapshotValues[i]->store(preset->values[i], std::memory_order_relaxed);
 
-            SIMD modVec = SIMD::fromRawArray(modVals);
-            SIMD inVec = SIMD::fromRawArray(data + i);
-            SIMD blendVec(blend);
-            SIMD oneMinusBlend(1.0f - blend);
+        appliedPreset.store(preset);
+    }
 
-            // Output = (1 - blend) * input + blend * modulator * input
-            SIMD outVec = oneMinusBlend * inVec + blendVec * modVec * inVec;
-            outVec.copyToRawArray(data + i);
+    engine.setSettings(readSettings());
 
-            localPhase += static_cast<float>(simdWidth) * phaseInc;
-            if (localPhase >= juce::MathConstants<float>::twoPi)
-                localPhase -= juce::MathConstants<float>::twoPi;
-        }
+    auto& pieceChannels = [this]() -> std::vector<SampleType*>&
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return blockChannelsDouble;
+        else
+            return blockChannels;
+    }();
+
+    // Main channels first, sidechain channels after the main inputs
+    auto* const* channels = buffer.getArrayOfWritePointers();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), getMainBusNumOutputChannels());
+    const int totalInputs = getMainBusNumInputChannels();
+    const int sidechainChannels = juce::jmin(getChannelCountOfBus(true, 1), buffer.getNumChannels() - totalInputs);
+
+    RingModIO<SampleType> io;
+    io.numInputs = totalInputs;
+    io.numOutputs = numChannels;
+    io.numSidechain = juce::jmax(sidechainChannels, 0);
+    io.midi = midiScratch.data();
+
+    // Host MIDI goes to the engine as raw events, a batch at a time; a block
+    // with more than fit is split at the first event left over
+    auto event = midi.cbegin();
+    const auto lastEvent = midi.cend();
+
+    for (int start = 0; start < numSamples;)
+    {
+        int numEvents = 0;
+        int end = numSamples;
 
-        // Scalar tail
-        for (int i = static_cast<int>(vectorSamples); i < numSamples; ++i)
+        for (; event != lastEvent; ++event)
         {
-            float modulator = 0.0f;
-            switch (currentWaveform)
+            const auto metadata = *event;
+
+            if (numEvents == static_cast<int>(midiScratch.size()))
             {
-            case Waveform::Sine:
-                modulator = sineWave(localPhase);
-                break;
-            case Waveform::Triangle:
-                modulator = triangleWave(localPhase);
-                break;
-            case Waveform::Square:
-                modulator = squareWave(localPhase);
+                end = juce::jlimit(start + 1, numSamples, metadata.samplePosition);
                 break;
             }
 
-            data[i] = (1.0f - blend) * data[i] + blend * modulator * data[i];
-            localPhase += phaseInc;
-            if (localPhase >= juce::MathConstants<float>::twoPi)
-                localPhase -= juce::MathConstants<float>::twoPi;
+            midiScratch[static_cast<size_t>(numEvents++)] =
+                { juce::jmax(metadata.samplePosition - start, 0), metadata.data, metadata.numBytes };
         }
-    }
 
-    // Update global phase
-    phase += static_cast<float>(numSamples) * phaseInc;
-    while (phase >= juce::MathConstants<float>::twoPi)
-        phase -= juce::MathConstants<float>::twoPi;
-}
+        auto* const* pieceStart = channels;
 
-//==============================================================================
-void DdxRingModAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
-{
-    juce::ScopedNoDenormals noDenormals;
+        if (start > 0 || end < numSamples)
+        {
+            const int count = juce::jmin(buffer.getNumChannels(), static_cast<int>(pieceChannels.size()));
 
-    // CPU monitoring
-    auto startTime = juce::Time::getMillisecondCounterHiRes();
-    auto numSamples = buffer.getNumSamples();
+            for (int ch = 0; ch < count; ++ch)
+                pieceChannels[static_cast<size_t>(ch)] = channels[ch] + start;
 
-    // Bypass
-    if (*apvts.getRawParameterValue("bypass") > 0.5f)
-        return;
+            pieceStart = pieceChannels.data();
+        }
+
+        io.channels = pieceStart;
+        io.sidechain = io.numSidechain > 0 ? pieceStart + totalInputs : nullptr;
+        io.numSamples = end - start;
+        io.numMidiEvents = numEvents;
+        engine.process(io);
+        start = end;
+    }
+
+    // Factor changes (parameter or realtime/offline switch) take effect in
+    // the engine; the host hears about the new latency asynchronously
+    pendingLatency = engine.getLatencySamples();
 
-    // Get parameters
-    float rateParam = *apvts.getRawParameterValue("rate");
-    float blend = *apvts.getRawParameterValue("blend");
-    int waveformIdx = static_cast<int> (*apvts.getRawParameterValue("waveform"));
-    useSIMD = *apvts.getRawParameterValue("simd") > 0.5f;
-    currentWaveform = static_cast<Waveform> (waveformIdx);
-
-    // Compute phase increment: Map rate (0-1) to frequency (0.5-20Hz) as per SHARC code
-    float freq = 0.5f + 19.5f * rateParam; // 0.5Hz to 20Hz
-    phaseInc = static_cast<float>(juce::MathConstants<float>::twoPi * freq / currentSampleRate);
-
-    // Process based on SIMD mode
-    if (useSIMD)
-        processBlockSIMD(buffer, blend);
-    else
-        processBlockScalar(buffer, blend);
-
-    // Update CPU usage
-    auto endTime = juce::Time::getMillisecondCounterHiRes();
-    double blockTime = (endTime - startTime) / 1000.0; // seconds
-    double expectedBlockTime = static_cast<double>(numSamples) / currentSampleRate;
-    cpuUsage = blockTime / expectedBlockTime;
+    analyzer.push(buffer.getArrayOfReadPointers(), numChannels, numSamples);
 }
 
 //==============================================================================
@@ -263,13 +595,39 @@ juce::AudioProcessorEditor* DdxRingModAudioProcessor::createEditor()
 //==============================================================================
 void DdxRingModAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Compact binary: a few dozen bytes, no ValueTree or XML involved.
+    // A preset still waiting for the audio thread is saved as if applied.
+    auto snapshot = captureParameters();
+
+    if (auto* preset = pendingPreset.load(std::memory_order_acquire))
+        for (size_t i = 0; i < snapshot.values.size(); ++i)
+            if (ParameterSnapshot::isInPresets(static_cast<int>(i)))
+                snapshot.values[i] = preset->values[i];
+
+    destData.reset();
+    snapshot.write(destData, currentProgram.load());
 }
 
 void DdxRingModAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    // A preset switch still in flight would land over the session
+    pendingPreset.store(nullptr, std::memory_order_release);
+
+    // Values the session doesn't have keep their current setting
+    auto snapshot = captureParameters();
+    int program = 0;
+
+    if (snapshot.read(data, sizeInBytes, program))
+    {
+        setParameters(snapshot, false);
+
+        if (juce::isPositiveAndBelow(program, presetBank.getNumPresets()))
+            currentProgram.store(program);
+
+        return;
+    }
+
+    // Sessions saved before the binary format
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState != nullptr)
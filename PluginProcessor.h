@@ -2,17 +2,23 @@
   DDX3216 Ring Modulator Plugin
   JUCE 8.0.11 - Faithful SHARC DSP Port with SIMD Optimization
   Based on Behringer DDX3216's SHARC ADSP-21160 ring mod algorithms
-  Supports both scalar (authentic) and SIMD (optimized) processing
+  Supports both scalar (authentic) and SIMD (optimized) processing,
+  plus an emulation of the SHARC's 32-bit and 40-bit arithmetic
   Waveforms: Sine, Triangle, Square
 */
 
 #pragma once
 #include <JuceHeader.h>
+#include "RingModEngine.h"
+#include "PerfMonitor.h"
+#include "SignalAnalyzer.h"
+#include "PresetBank.h"
 
 //==============================================================================
 // Main Plugin Processor
 //==============================================================================
-class DdxRingModAudioProcessor : public juce::AudioProcessor
+class DdxRingModAudioProcessor : public juce::AudioProcessor,
+                                 private juce::Timer
 {
 public:
     DdxRingModAudioProcessor();
@@ -22,54 +28,155 @@ public:
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
 
     const juce::String getName() const override { return "DDX3216 Ring Modulator"; }
-    bool acceptsMidi() const override { return false; }
+    bool acceptsMidi() const override { return true; }
     bool producesMidi() const override { return false; }
     bool isMidiEffect() const override { return false; }
     double getTailLengthSeconds() const override { return 0.0; }
 
-    int getNumPrograms() override { return 1; }
-    int getCurrentProgram() override { return 0; }
-    void setCurrentProgram(int) override {}
-    const juce::String getProgramName(int) override { return {}; }
-    void changeProgramName(int, const juce::String&) override {}
+    // Programs come from the preset bank. On the message thread
+    // setCurrentProgram applies the preset straight away; from any other
+    // thread it is lock-free and the preset takes effect, whole, at the
+    // start of the next block (or from the message thread, if no block
+    // comes).
+    int getNumPrograms() override { return juce::jmax(1, presetBank.getNumPresets()); }
+    int getCurrentProgram() override { return currentProgram.load(); }
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override { return presetBank.getName(index); }
+    void changeProgramName(int index, const juce::String& newName) override { presetBank.setName(index, newName); }
 
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
 
-    // CPU monitoring
-    float getCpuUsage() const { return static_cast<float>(cpuUsage); }
+    // Message thread: stores the current settings as a preset
+    void storePreset(int index, const juce::String& name);
 
-private:
-    enum class Waveform { Sine, Triangle, Square };
+    // CPU monitoring (safe from any non-audio thread)
+    PerfSnapshot getPerformanceSnapshot() noexcept { return perfMonitor.getSnapshot(); }
+    void resetPerformanceStats() noexcept { perfMonitor.reset(); }
+    void setOverrunThreshold(float loadFraction) noexcept { perfMonitor.setOverrunThreshold(loadFraction); }
+
+    // Output scope and spectrum; idle until an editor attaches
+    SignalAnalyzer& getAnalyzer() noexcept { return analyzer; }
+
+    // Offline rendering: clears the filters and moves the carrier to where
+    // it would be samplePosition samples after prepareToPlay, parameters
+    // held constant. Instances seeked to block-aligned positions (plus a
+    // short pre-roll to refill the oversampling filters) render
+    // bit-identical pieces of the same file - except with dynamics on,
+    // whose envelope and modulated phase a seek can't rebuild (see
+    // RingModEngine::seekTo).
+    void seekTo(int64_t samplePosition);
 
+    // Instruction set the SIMD kernels were picked for at startup
+    SimdLevel getSimdLevel() const noexcept { return engine.getSimdLevel(); }
+    juce::String getSimdKernelName() const { return getSimdLevelName(engine.getSimdLevel()); }
+
+private:
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    // Oscillator state
-    float phase = 0.0f;
-    float phaseInc = 0.0f;
-    double currentSampleRate = 48000.0;
-    bool useSIMD = false;
-    Waveform currentWaveform = Waveform::Sine;
+    // Shared by the float and double processBlock overloads
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midi);
+
+    // The engine's view of the current parameter values
+    RingModSettings readSettings() const noexcept;
+
+    // Oversampling stages wanted for the current render mode
+    int getWantedOversamplingStages() const noexcept;
+
+    // Presets and session state
+    void addFactoryPresets();
+    ParameterSnapshot captureParameters() const noexcept;
+    void setParameters(const ParameterSnapshot& snapshot, bool presetOnly);
+
+    // After the audio thread applied a preset: pushes its values to the
+    // parameters, except those the host or editor has moved since
+    void catchUpParameters(const ParameterSnapshot& preset);
+
+    // Message thread: picks up what the audio thread left (latency, applied
+    // preset). Polled, because posting a message can block the poster.
+    void timerCallback() override;
+
+    // Raw parameter values, resolved once instead of by ID every block
+    struct ParameterHandles
+    {
+        std::atomic<float>* rate = nullptr;
+        std::atomic<float>* blend = nullptr;
+        std::atomic<float>* waveform = nullptr;
+        std::atomic<float>* bypass = nullptr;
+        std::atomic<float>* simd = nullptr;
+        std::atomic<float>* range = nullptr;
+        std::atomic<float>* oversampling = nullptr;
+        std::atomic<float>* renderOversampling = nullptr;
+        std::atomic<float>* spread = nullptr;
+        std::atomic<float>* carriers = nullptr;
+        std::atomic<float>* midi = nullptr;
+        std::atomic<float>* glide = nullptr;
+        std::atomic<float>* bendRange = nullptr;
+        std::atomic<float>* carrierSource = nullptr;
+        std::atomic<float>* dynamics = nullptr;
+        std::atomic<float>* envAttack = nullptr;
+        std::atomic<float>* envRelease = nullptr;
+        std::atomic<float>* envRange = nullptr;
+        std::atomic<float>* envToRate = nullptr;
+        std::atomic<float>* envToBlend = nullptr;
+        std::atomic<float>* emulation = nullptr;
+
+        struct CarrierHandles
+        {
+            std::atomic<float>* ratio = nullptr;
+            std::atomic<float>* detune = nullptr;
+            std::atomic<float>* waveform = nullptr;
+            std::atomic<float>* level = nullptr;
+        };
+
+        std::array<CarrierHandles, ParameterSnapshot::numExtraCarriers> extraCarriers;
+    };
+
+    ParameterHandles paramHandles;
+
+    // Every parameter in snapshot order, for state and presets
+    std::array<juce::RangedAudioParameter*, ParameterSnapshot::numParameters> snapshotParameters {};
+    std::array<std::atomic<float>*, ParameterSnapshot::numParameters> snapshotValues {};
+
+    // Preset switching off the message thread: setCurrentProgram posts a
+    // snapshot, the audio thread applies it to the raw values and hands it
+    // back for the message thread to push to the parameters (host and
+    // editor). One still waiting a timer tick later is applied there.
+    PresetBank presetBank;
+    std::atomic<const ParameterSnapshot*> pendingPreset { nullptr };
+    std::atomic<const ParameterSnapshot*> appliedPreset { nullptr };
+    const ParameterSnapshot* waitingPreset = nullptr;      // pending at the last tick
+    std::atomic<int> currentProgram { 0 };
+
+    // All of the DSP; the processor feeds it parameters, audio and MIDI
+    RingModEngine engine;
+
+    // Host MIDI as raw events for the engine, and channel pointers for
+    // blocks split to take more events than fit
+    std::array<RingModMidiEvent, 256> midiScratch {};
+    std::vector<float*> blockChannels;
+    std::vector<double*> blockChannelsDouble;
+
+    // Latency changes found on the audio thread are reported from the
+    // message thread
+    std::atomic<int> pendingLatency { 0 };
 
     // CPU monitoring
-    double cpuUsage = 0.0;
-
-    // Helper functions for waveforms (optimized for audio)
-    float sineWave(float t) const noexcept;
-    float triangleWave(float t) const noexcept;
-    float squareWave(float t) const noexcept;
+    BlockPerfMonitor perfMonitor;
 
-    // Process blocks
-    void processBlockScalar(juce::AudioBuffer<float>& buffer, float blend);
-    void processBlockSIMD(juce::AudioBuffer<float>& buffer, float blend);
+    // Output analysis for the editor
+    SignalAnalyzer analyzer;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DdxRingModAudioProcessor)
 };
\ No newline at end of file
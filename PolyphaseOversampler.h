@@ -0,0 +1,265 @@
+/*
+  DDX3216 Ring Modulator Plugin - Polyphase Oversampling
+  2x/4x/8x up- and downsampling as a cascade of linear-phase half-band FIR
+  stages. Every other half-band tap is zero, so each stage runs only its
+  odd-tap polyphase branch through the SIMD FIR kernel (RingModKernels.h);
+  the other branch is a plain delay. Later stages run at higher rates on
+  already band-limited audio and get away with far fewer taps.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "RingModKernels.h"
+#include "RingModSimd.h"
+#include "SharedTables.h"
+
+//==============================================================================
+// Odd-branch taps of one half-band design, shared by every instance
+//==============================================================================
+template <typename SampleType>
+struct HalfbandCoefficients
+{
+    std::vector<SampleType> down;   // odd taps, the branch sums to 0.5
+    std::vector<SampleType> up;     // the same doubled (interpolation gain)
+};
+
+//==============================================================================
+// One 2x stage. Latency is halfTaps samples at the stage's lower rate in
+// each direction, so it is always a whole number of samples.
+//==============================================================================
+template <typename SampleType>
+class HalfbandStage
+{
+public:
+    // halfTaps odd taps either side of the centre (4 * halfTaps - 1 in total)
+    void prepare(int newHalfTaps, int numChannels, int maxInputSamples, FirKernel<SampleType> kernel)
+    {
+        halfTaps = newHalfTaps;
+        numTaps = 2 * halfTaps;
+        fir = kernel;
+        coeffs = SharedTables::get<HalfbandCoefficients<SampleType>>(0.0, halfTaps, [this] { return design(); });
+
+        channels.resize(static_cast<size_t>(numChannels));
+        for (auto& state : channels)
+        {
+            state.upHistory.assign(static_cast<size_t>(numTaps - 1 + maxInputSamples), SampleType());
+            state.downOdd.assign(static_cast<size_t>(numTaps + maxInputSamples), SampleType());
+            state.downEven.assign(static_cast<size_t>(halfTaps + maxInputSamples), SampleType());
+        }
+
+        filtered.assign(static_cast<size_t>(maxInputSamples), SampleType());
+    }
+
+    void reset() noexcept
+    {
+        for (auto& state : channels)
+        {
+            std::fill(state.upHistory.begin(), state.upHistory.end(), SampleType());
+            std::fill(state.downOdd.begin(), state.downOdd.end(), SampleType());
+            std::fill(state.downEven.begin(), state.downEven.end(), SampleType());
+        }
+    }
+
+    int getHalfTaps() const noexcept { return halfTaps; }
+
+    // numSamples in -> 2 * numSamples out. Even outputs are the input
+    // delayed by halfTaps, odd outputs the interpolating branch.
+    void upsample(int channel, const SampleType* in, SampleType* out, int numSamples) noexcept
+    {
+        auto& history = channels[static_cast<size_t>(channel)].upHistory;
+        const int historySize = numTaps - 1;
+        SampleType* h = history.data();
+
+        std::copy(in, in + numSamples, h + historySize);
+        fir(h, coeffs->up.data(), numTaps, filtered.data(), numSamples);
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            out[2 * n] = h[n + halfTaps - 1];
+            out[2 * n + 1] = filtered[static_cast<size_t>(n)];
+        }
+
+        std::copy(h + numSamples, h + numSamples + historySize, h);
+    }
+
+    // 2 * numSamples in -> numSamples out (in and out may alias)
+    void downsample(int channel, const SampleType* in, SampleType* out, int numSamples) noexcept
+    {
+        auto& state = channels[static_cast<size_t>(channel)];
+        SampleType* odd = state.downOdd.data();
+        SampleType* even = state.downEven.data();
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            even[halfTaps + n] = in[2 * n];
+            odd[numTaps + n] = in[2 * n + 1];
+        }
+
+        fir(odd, coeffs->down.data(), numTaps, filtered.data(), numSamples);
+
+        for (int n = 0; n < numSamples; ++n)
+            out[n] = SampleType(0.5) * even[n] + filtered[static_cast<size_t>(n)];
+
+        std::copy(odd + numSamples, odd + numSamples + numTaps, odd);
+        std::copy(even + numSamples, even + numSamples + halfTaps, even);
+    }
+
+private:
+    static constexpr double pi = 3.14159265358979323846;
+    static constexpr double kaiserBeta = 8.0;
+
+    // Odd half-band taps h[m] = sin(pi m / 2) / (pi m), Kaiser windowed,
+    // normalised so the odd branch sums to 0.5 (unity gain at DC)
+    std::shared_ptr<const HalfbandCoefficients<SampleType>> design() const
+    {
+        auto table = std::make_shared<HalfbandCoefficients<SampleType>>();
+        table->down.assign(static_cast<size_t>(numTaps), SampleType());
+        double sum = 0.0;
+
+        for (int j = 0; j < numTaps; ++j)
+        {
+            const int m = numTaps - 2 * j - 1;
+            const double x = static_cast<double>(m) / static_cast<double>(numTaps);
+            const double window = besselI0(kaiserBeta * std::sqrt(1.0 - x * x)) / besselI0(kaiserBeta);
+            const double h = std::sin(0.5 * pi * m) / (pi * m) * window;
+            table->down[static_cast<size_t>(j)] = static_cast<SampleType>(h);
+            sum += h;
+        }
+
+        for (auto& c : table->down)
+            c = static_cast<SampleType>(static_cast<double>(c) * 0.5 / sum);
+
+        table->up = table->down;
+        for (auto& c : table->up)
+            c *= SampleType(2);
+
+        return table;
+    }
+
+    static double besselI0(double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x * 0.5 / k) * (x * 0.5 / k);
+            sum += term;
+        }
+        return sum;
+    }
+
+    struct ChannelState
+    {
+        std::vector<SampleType> upHistory;  // last numTaps - 1 inputs, then the block
+        std::vector<SampleType> downOdd;    // last numTaps odd inputs, then the block
+        std::vector<SampleType> downEven;   // last halfTaps even inputs, then the block
+    };
+
+    int halfTaps = 0;
+    int numTaps = 0;
+    FirKernel<SampleType> fir = nullptr;
+    std::shared_ptr<const HalfbandCoefficients<SampleType>> coeffs;
+    std::vector<ChannelState> channels;
+    std::vector<SampleType> filtered;
+};
+
+//==============================================================================
+// Up to three cascaded stages (8x). Everything is allocated for 8x in
+// prepare(), so the factor can change on the audio thread.
+//==============================================================================
+template <typename SampleType>
+class PolyphaseOversampler
+{
+public:
+    static constexpr int maxStages = 3;
+
+    void prepare(int numChannels, int maxBlockSize, SimdLevel level)
+    {
+        const auto fir = getFirKernel<SampleType>(level);
+        maxSamples = std::max(maxBlockSize, 1);
+
+        for (int s = 0; s < maxStages; ++s)
+        {
+            const int stageInput = maxSamples << s;
+            stages[s].prepare(stageHalfTaps[s], numChannels, stageInput, fir);
+
+            buffers[s].resize(static_cast<size_t>(numChannels));
+            for (auto& channel : buffers[s])
+                channel.allocate(stageInput * 2);
+
+            pointers[s].resize(static_cast<size_t>(numChannels));
+            for (size_t ch = 0; ch < pointers[s].size(); ++ch)
+                pointers[s][ch] = buffers[s][ch].get();
+        }
+    }
+
+    void reset() noexcept
+    {
+        for (auto& stage : stages)
+            stage.reset();
+    }
+
+    // 0 = off, 1 = 2x, 2 = 4x, 3 = 8x; filter state restarts on a change
+    void setNumStages(int newNumStages) noexcept
+    {
+        newNumStages = std::clamp(newNumStages, 0, maxStages);
+        if (newNumStages != numStages)
+        {
+            numStages = newNumStages;
+            reset();
+        }
+    }
+
+    int getNumStages() const noexcept { return numStages; }
+    int getFactor() const noexcept { return 1 << numStages; }
+    int getMaxBlockSize() const noexcept { return maxSamples; }
+
+    // Round-trip latency in base-rate samples
+    static int getLatencySamples(int stagesUsed) noexcept
+    {
+        int latency = 0;
+        for (int s = 0; s < std::clamp(stagesUsed, 0, maxStages); ++s)
+            latency += 2 * stageHalfTaps[s] / (1 << s);
+        return latency;
+    }
+
+    // Upsamples [startSample, startSample + numSamples) of every channel,
+    // numSamples <= getMaxBlockSize() and at least one stage enabled.
+    // Returns the oversampled channels, numSamples * getFactor() long.
+    SampleType* const* processUp(const SampleType* const* input, int numChannels, int startSample, int numSamples) noexcept
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            stages[0].upsample(ch, input[ch] + startSample, pointers[0][static_cast<size_t>(ch)], numSamples);
+
+        for (int s = 1; s < numStages; ++s)
+            for (int ch = 0; ch < numChannels; ++ch)
+                stages[s].upsample(ch, pointers[s - 1][static_cast<size_t>(ch)],
+                                   pointers[s][static_cast<size_t>(ch)], numSamples << s);
+
+        return pointers[numStages - 1].data();
+    }
+
+    // Back down into the same region of output once the oversampled
+    // channels have been processed in place
+    void processDown(SampleType* const* output, int numChannels, int startSample, int numSamples) noexcept
+    {
+        for (int s = numStages - 1; s > 0; --s)
+            for (int ch = 0; ch < numChannels; ++ch)
+                stages[s].downsample(ch, pointers[s][static_cast<size_t>(ch)],
+                                     pointers[s - 1][static_cast<size_t>(ch)], numSamples << s);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            stages[0].downsample(ch, pointers[0][static_cast<size_t>(ch)], output[ch] + startSample, numSamples);
+    }
+
+private:
+    // Odd taps per side: 63, 31 and 23 tap half-bands
+    static constexpr int stageHalfTaps[maxStages] = { 16, 8, 6 };
+
+    HalfbandStage<SampleType> stages[maxStages];
+    std::vector<SimdAlignedBuffer<SampleType>> buffers[maxStages];
+    std::vector<SampleType*> pointers[maxStages];
+    int numStages = 0;
+    int maxSamples = 1;
+};
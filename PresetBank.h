@@ -0,0 +1,201 @@
+/*
+  DDX3216 Ring Modulator Plugin - State and Presets
+  JUCE 8.0.11
+  A flat snapshot of every parameter, the compact binary session format
+  built on it, and an in-memory preset bank. Snapshots are built on the
+  message thread and never change once published, so the audio thread can
+  switch presets by swapping a single pointer.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+// Plain (denormalised) value of every parameter
+//==============================================================================
+struct ParameterSnapshot
+{
+    struct Entry
+    {
+        const char* id;
+        bool inPresets;     // false: session-only (bypass, processing mode)
+    };
+
+    // Stored order. Append only: the binary format depends on it.
+    static constexpr std::array<Entry, 10> parameters {{
+        { "rate", true },
+        { "blend", true },
+        { "waveform", true },
+        { "bypass", false },
+        { "simd", false },
+        { "range", true },
+        { "oversampling", true },
+        { "renderOversampling", false },
+        { "spread", true },
+        { "carriers", true }
+    }};
+
+    // Then one group per extra carrier of the bank (2 to 16):
+    // "carrier2Ratio", "carrier2Detune", "carrier2Waveform", "carrier2Level", ...
+    static constexpr int numExtraCarriers = 15;
+    static constexpr std::array<const char*, 4> carrierFields { "Ratio", "Detune", "Waveform", "Level" };
+
+    // Then everything added after the carrier bank, in the order added
+    static constexpr std::array<Entry, 11> laterParameters {{
+        { "midi", true },
+        { "glide", true },
+        { "bendRange", true },
+        { "carrierSource", true },
+        { "dynamics", true },
+        { "envAttack", true },
+        { "envRelease", true },
+        { "envRange", true },
+        { "envToRate", true },
+        { "envToBlend", true },
+        { "emulation", false }
+    }};
+
+    static constexpr int numNamed = static_cast<int>(parameters.size());
+    static constexpr int bankEnd = numNamed + numExtraCarriers * static_cast<int>(carrierFields.size());
+    static constexpr int numParameters = bankEnd + static_cast<int>(laterParameters.size());
+
+    static juce::String getCarrierParameterId(int carrier, int field)
+    {
+        return "carrier" + juce::String(carrier) + carrierFields[static_cast<size_t>(field)];
+    }
+
+    static juce::String getParameterId(int index)
+    {
+        if (index < numNamed)
+            return parameters[static_cast<size_t>(index)].id;
+
+        if (index >= bankEnd)
+            return laterParameters[static_cast<size_t>(index - bankEnd)].id;
+
+        const int fields = static_cast<int>(carrierFields.size());
+        return getCarrierParameterId((index - numNamed) / fields + 2, (index - numNamed) % fields);
+    }
+
+    static constexpr bool isInPresets(int index) noexcept
+    {
+        if (index >= bankEnd)
+            return laterParameters[static_cast<size_t>(index - bankEnd)].inPresets;
+
+        return index >= numNamed || parameters[static_cast<size_t>(index)].inPresets;
+    }
+
+    std::array<float, numParameters> values {};
+
+    //==============================================================================
+    // Binary session format, little-endian:
+    //   uint32 magic, uint16 version, uint16 count, int32 program, float[count]
+    // Readers take the values they know and leave the rest as they were, so
+    // older and newer sessions both load.
+    static constexpr uint32_t magic = 0x53584444;  // "DDXS"
+    static constexpr uint16_t version = 1;
+
+    void write(juce::MemoryBlock& dest, int program) const
+    {
+        juce::MemoryOutputStream out(dest, false);
+        out.writeInt(static_cast<int>(magic));
+        out.writeShort(static_cast<short>(version));
+        out.writeShort(static_cast<short>(numParameters));
+        out.writeInt(program);
+
+        for (auto value : values)
+            out.writeFloat(value);
+    }
+
+    // Returns false if data isn't in this format (e.g. an XML session)
+    bool read(const void* data, int sizeInBytes, int& program)
+    {
+        constexpr int headerSize = 12;
+
+        if (data == nullptr || sizeInBytes < headerSize)
+            return false;
+
+        juce::MemoryInputStream in(data, static_cast<size_t>(sizeInBytes), false);
+
+        if (static_cast<uint32_t>(in.readInt()) != magic)
+            return false;
+
+        if (static_cast<uint16_t>(in.readShort()) < 1)
+            return false;
+
+        const int count = static_cast<uint16_t>(in.readShort());
+        program = in.readInt();
+
+        const int available = (sizeInBytes - headerSize) / static_cast<int>(sizeof(float));
+        const int known = juce::jmin(count, available, numParameters);
+
+        for (int i = 0; i < known; ++i)
+            values[static_cast<size_t>(i)] = in.readFloat();
+
+        return true;
+    }
+};
+
+//==============================================================================
+// Preset slots. Published snapshots are immutable and kept until the bank
+// is destroyed, so a pointer read on the audio thread stays valid even if
+// the slot is replaced straight after.
+//==============================================================================
+class PresetBank
+{
+public:
+    static constexpr int maxPresets = 128;
+
+    PresetBank()
+    {
+        for (auto& slot : slots)
+            slot.store(nullptr);
+    }
+
+    // Message thread
+    void setPreset(int index, const juce::String& name, const ParameterSnapshot& snapshot)
+    {
+        if (! juce::isPositiveAndBelow(index, maxPresets))
+            return;
+
+        storage.push_back(std::make_unique<ParameterSnapshot>(snapshot));
+        names[static_cast<size_t>(index)] = name;
+        slots[static_cast<size_t>(index)].store(storage.back().get(), std::memory_order_release);
+
+        if (index >= numPresets.load())
+            numPresets.store(index + 1);
+    }
+
+    void setName(int index, const juce::String& name)
+    {
+        if (juce::isPositiveAndBelow(index, maxPresets))
+            names[static_cast<size_t>(index)] = name;
+    }
+
+    juce::String getName(int index) const
+    {
+        return juce::isPositiveAndBelow(index, maxPresets) ? names[static_cast<size_t>(index)] : juce::String();
+    }
+
+    // Any thread
+    int getNumPresets() const noexcept { return numPresets.load(std::memory_order_relaxed); }
+
+    // Any thread, lock-free; nullptr for an empty slot
+    const ParameterSnapshot* get(int index) const noexcept
+    {
+        return juce::isPositiveAndBelow(index, maxPresets)
+                   ? slots[static_cast<size_t>(index)].load(std::memory_order_acquire)
+                   : nullptr;
+    }
+
+private:
+    std::array<std::atomic<const ParameterSnapshot*>, maxPresets> slots;
+    std::array<juce::String, maxPresets> names;
+    std::vector<std::unique_ptr<ParameterSnapshot>> storage;
+    std::atomic<int> numPresets { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBank)
+};
@@ -0,0 +1,333 @@
+/*
+  DDX3216 Ring Modulator Plugin - C API Implementation
+*/
+
+#include "RingModCApi.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <new>
+#include <vector>
+#include "RingModEngine.h"
+#include "RingModVoiceBatch.h"
+
+struct DdxRingMod
+{
+    RingModEngine engine;
+    RingModSettings settings;
+
+    bool prepared = false;
+    int numChannels = 0, numSidechain = 0, maxBlockSize = 0;
+
+    // Planar scratch for interleaved processing, with pointers to it, and
+    // the channel pointers handed to the engine
+    std::vector<float> buffer, sidechainBuffer;
+    std::vector<float*> planar;
+    std::vector<const float*> planarSidechain;
+    std::vector<float*> channels;
+    std::vector<const float*> sidechain;
+
+    // Events handed to the engine, converted a batch at a time
+    std::array<RingModMidiEvent, 256> midi {};
+};
+
+struct DdxRingModBatch
+{
+    RingModVoiceBatch batch;
+    bool prepared = false;
+};
+
+namespace
+{
+    // Processes numSamples samples of planar audio, the block's offset-th
+    // sample onwards. MIDI is consumed from the cursor; blocks with more
+    // events than fit the batch are split at the first one left over. The
+    // last piece of a block also takes events stamped past its end, which
+    // still count, as in the plugin.
+    void processPlanar(DdxRingMod& ringmod, float* const* channels, const float* const* sidechain,
+                       int offset, int numSamples, bool last, const DdxRingModMidiEvent*& midi,
+                       const DdxRingModMidiEvent* midiEnd) noexcept
+    {
+        const int end = offset + numSamples;
+
+        for (int start = offset; start < end;)
+        {
+            int numEvents = 0;
+            int chunkEnd = end;
+
+            for (; midi != midiEnd; ++midi)
+            {
+                if (midi->sample_position >= end && ! last)
+                    break;
+
+                if (numEvents == static_cast<int>(ringmod.midi.size()))
+                {
+                    chunkEnd = std::clamp(static_cast<int>(midi->sample_position), start + 1, end);
+                    break;
+                }
+
+                ringmod.midi[static_cast<size_t>(numEvents++)] =
+                    { std::max(static_cast<int>(midi->sample_position) - start, 0), midi->data, midi->num_bytes };
+            }
+
+            for (int ch = 0; ch < ringmod.numChannels; ++ch)
+                ringmod.channels[static_cast<size_t>(ch)] = channels[ch] + start - offset;
+
+            for (int ch = 0; sidechain != nullptr && ch < ringmod.numSidechain; ++ch)
+                ringmod.sidechain[static_cast<size_t>(ch)] = sidechain[ch] + start - offset;
+
+            RingModIO<float> io;
+            io.channels = ringmod.channels.data();
+            io.numInputs = io.numOutputs = ringmod.numChannels;
+            io.sidechain = sidechain != nullptr && ringmod.numSidechain > 0 ? ringmod.sidechain.data() : nullptr;
+            io.numSidechain = ringmod.numSidechain;
+            io.numSamples = chunkEnd - start;
+            io.midi = ringmod.midi.data();
+            io.numMidiEvents = numEvents;
+
+            ringmod.engine.setSettings(ringmod.settings);
+            ringmod.engine.process(io);
+            start = chunkEnd;
+        }
+    }
+}
+
+//==============================================================================
+DdxRingMod* ddx_ringmod_create(void)
+{
+    return new (std::nothrow) DdxRingMod();
+}
+
+void ddx_ringmod_destroy(DdxRingMod* ringmod)
+{
+    delete ringmod;
+}
+
+int ddx_ringmod_prepare(DdxRingMod* ringmod, double sampleRate, int maxBlockSize, int numChannels,
+                        int numSidechain)
+{
+    if (ringmod == nullptr || ! (sampleRate > 0.0) || maxBlockSize < 1 || numChannels < 1
+        || (numSidechain != 0 && numSidechain != 1 && numSidechain != numChannels))
+        return 0;
+
+    ringmod->prepared = false;
+
+    try
+    {
+        const auto samples = static_cast<size_t>(maxBlockSize);
+        ringmod->buffer.assign(samples * static_cast<size_t>(numChannels), 0.0f);
+        ringmod->sidechainBuffer.assign(samples * static_cast<size_t>(numSidechain), 0.0f);
+        ringmod->channels.assign(static_cast<size_t>(numChannels), nullptr);
+        ringmod->sidechain.assign(static_cast<size_t>(std::max(numSidechain, 1)), nullptr);
+        ringmod->planar.resize(static_cast<size_t>(numChannels));
+        ringmod->planarSidechain.resize(static_cast<size_t>(std::max(numSidechain, 1)));
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            ringmod->planar[static_cast<size_t>(ch)] = ringmod->buffer.data() + static_cast<size_t>(ch) * samples;
+
+        for (int ch = 0; ch < numSidechain; ++ch)
+            ringmod->planarSidechain[static_cast<size_t>(ch)] = ringmod->sidechainBuffer.data() + static_cast<size_t>(ch) * samples;
+
+        ringmod->engine.setSettings(ringmod->settings);
+        ringmod->engine.prepare(sampleRate, maxBlockSize, numChannels, numSidechain, false);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return 0;
+    }
+
+    ringmod->numChannels = numChannels;
+    ringmod->numSidechain = numSidechain;
+    ringmod->maxBlockSize = maxBlockSize;
+    ringmod->prepared = true;
+    return 1;
+}
+
+//==============================================================================
+void ddx_ringmod_set_param(DdxRingMod* ringmod, DdxRingModParam param, float value)
+{
+    // NaN would pass straight through the clamps below
+    if (ringmod == nullptr || ! std::isfinite(value))
+        return;
+
+    auto& settings = ringmod->settings;
+    const bool on = value > 0.5f;
+    const int index = static_cast<int>(std::lround(value));
+
+    switch (param)
+    {
+    case DDX_RINGMOD_RATE:          settings.rate = std::clamp(value, 0.0f, 1.0f); break;
+    case DDX_RINGMOD_BLEND:         settings.blend = std::clamp(value, 0.0f, 1.0f); break;
+    case DDX_RINGMOD_WAVEFORM:      settings.waveform = static_cast<DdsWaveform>(std::clamp(index, 0, 2)); break;
+    case DDX_RINGMOD_BYPASS:        settings.bypass = on; break;
+    case DDX_RINGMOD_SIMD:          settings.simd = on; break;
+    case DDX_RINGMOD_AUDIO_RANGE:   settings.audioRange = on; break;
+    case DDX_RINGMOD_OVERSAMPLING:  settings.oversamplingStages = std::clamp(index, 0, 3); break;
+    case DDX_RINGMOD_SPREAD:        settings.spread = std::clamp(value, 0.0f, 1.0f); break;
+    case DDX_RINGMOD_CARRIERS:      settings.numCarriers = std::clamp(index, 1, CarrierBank::maxCarriers); break;
+    case DDX_RINGMOD_MIDI:          settings.midi = on; break;
+    case DDX_RINGMOD_GLIDE:         settings.glideMs = std::max(value, 0.0f); break;
+    case DDX_RINGMOD_BEND_RANGE:    settings.bendRange = value; break;
+    case DDX_RINGMOD_SIDECHAIN:     settings.sidechain = on; break;
+    case DDX_RINGMOD_DYNAMICS:      settings.dynamics = on; break;
+    case DDX_RINGMOD_ENV_ATTACK:    settings.envAttackMs = value; break;
+    case DDX_RINGMOD_ENV_RELEASE:   settings.envReleaseMs = value; break;
+    case DDX_RINGMOD_ENV_RANGE:     settings.envRangeDb = std::max(value, 1.0f); break;
+    case DDX_RINGMOD_ENV_TO_RATE:   settings.envToRate = value; break;
+    case DDX_RINGMOD_ENV_TO_BLEND:  settings.envToBlend = std::clamp(value, -1.0f, 1.0f); break;
+    case DDX_RINGMOD_EMULATION:     settings.emulation = std::clamp(index, 0, 2); break;
+    default: break;
+    }
+}
+
+void ddx_ringmod_set_carrier_param(DdxRingMod* ringmod, int carrier, DdxRingModCarrierParam param, float value)
+{
+    if (ringmod == nullptr || carrier < 2 || carrier > CarrierBank::maxCarriers || ! std::isfinite(value))
+        return;
+
+    auto& settings = ringmod->settings.extraCarriers[static_cast<size_t>(carrier - 2)];
+
+    switch (param)
+    {
+    case DDX_RINGMOD_CARRIER_RATIO:     settings.ratio = std::max(value, 0.0f); break;
+    case DDX_RINGMOD_CARRIER_DETUNE:    settings.detune = value; break;
+    case DDX_RINGMOD_CARRIER_WAVEFORM:  settings.waveform = static_cast<DdsWaveform>(std::clamp(static_cast<int>(std::lround(value)), 0, 2)); break;
+    case DDX_RINGMOD_CARRIER_LEVEL:     settings.level = std::max(value, 0.0f); break;
+    default: break;
+    }
+}
+
+//==============================================================================
+void ddx_ringmod_process_planar(DdxRingMod* ringmod, float* const* channels, const float* const* sidechain,
+                                int numSamples, const DdxRingModMidiEvent* midi, int numMidiEvents)
+{
+    if (ringmod == nullptr || ! ringmod->prepared || channels == nullptr || numSamples <= 0)
+        return;
+
+    const DdxRingModMidiEvent* midiEnd = midi != nullptr ? midi + std::max(numMidiEvents, 0) : nullptr;
+    processPlanar(*ringmod, channels, sidechain, 0, numSamples, true, midi, midiEnd);
+}
+
+void ddx_ringmod_process_interleaved(DdxRingMod* ringmod, float* samples, const float* sidechain,
+                                     int numFrames, const DdxRingModMidiEvent* midi, int numMidiEvents)
+{
+    if (ringmod == nullptr || ! ringmod->prepared || samples == nullptr || numFrames <= 0)
+        return;
+
+    auto& r = *ringmod;
+    const int numChannels = r.numChannels;
+    const int numSidechain = sidechain != nullptr ? r.numSidechain : 0;
+    const DdxRingModMidiEvent* midiEnd = midi != nullptr ? midi + std::max(numMidiEvents, 0) : nullptr;
+
+    float* const* planar = r.planar.data();
+    const float* const* planarSidechain = r.planarSidechain.data();
+
+    for (int start = 0; start < numFrames; start += r.maxBlockSize)
+    {
+        const int chunk = std::min(numFrames - start, r.maxBlockSize);
+        float* frames = samples + static_cast<size_t>(start) * static_cast<size_t>(numChannels);
+
+        for (int i = 0; i < chunk; ++i)
+            for (int ch = 0; ch < numChannels; ++ch)
+                planar[ch][i] = frames[i * numChannels + ch];
+
+        if (numSidechain > 0)
+        {
+            const float* sidechainFrames = sidechain + static_cast<size_t>(start) * static_cast<size_t>(numSidechain);
+
+            for (int i = 0; i < chunk; ++i)
+                for (int ch = 0; ch < numSidechain; ++ch)
+                    r.sidechainBuffer[static_cast<size_t>(ch) * static_cast<size_t>(r.maxBlockSize) + static_cast<size_t>(i)] =
+                        sidechainFrames[i * numSidechain + ch];
+        }
+
+        // Event positions stay relative to the whole block
+        processPlanar(r, planar, numSidechain > 0 ? planarSidechain : nullptr, start, chunk,
+                      start + chunk == numFrames, midi, midiEnd);
+
+        for (int i = 0; i < chunk; ++i)
+            for (int ch = 0; ch < numChannels; ++ch)
+                frames[i * numChannels + ch] = planar[ch][i];
+    }
+}
+
+//==============================================================================
+int ddx_ringmod_get_latency(const DdxRingMod* ringmod)
+{
+    return ringmod != nullptr ? PolyphaseOversampler<float>::getLatencySamples(ringmod->settings.oversamplingStages) : 0;
+}
+
+void ddx_ringmod_seek(DdxRingMod* ringmod, int64_t samplePosition)
+{
+    if (ringmod == nullptr || ! ringmod->prepared)
+        return;
+
+    ringmod->engine.setSettings(ringmod->settings);
+    ringmod->engine.seekTo(samplePosition);
+}
+
+//==============================================================================
+DdxRingModBatch* ddx_ringmod_batch_create(void)
+{
+    return new (std::nothrow) DdxRingModBatch();
+}
+
+void ddx_ringmod_batch_destroy(DdxRingModBatch* batch)
+{
+    delete batch;
+}
+
+int ddx_ringmod_batch_prepare(DdxRingModBatch* batch, double sampleRate, int maxVoices, int channelsPerVoice)
+{
+    if (batch == nullptr || ! (sampleRate > 0.0) || maxVoices < 1 || channelsPerVoice < 1)
+        return 0;
+
+    batch->prepared = false;
+
+    try
+    {
+        batch->batch.prepare(sampleRate, maxVoices, channelsPerVoice);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return 0;
+    }
+
+    batch->prepared = true;
+    return 1;
+}
+
+void ddx_ringmod_batch_set_param(DdxRingModBatch* batch, int voice, DdxRingModParam param, float value)
+{
+    if (batch == nullptr || ! batch->prepared || voice < 0 || voice >= batch->batch.getMaxVoices()
+        || ! std::isfinite(value))
+        return;
+
+    auto settings = batch->batch.getVoice(voice);
+
+    switch (param)
+    {
+    case DDX_RINGMOD_RATE:          settings.rate = std::clamp(value, 0.0f, 1.0f); break;
+    case DDX_RINGMOD_BLEND:         settings.blend = std::clamp(value, 0.0f, 1.0f); break;
+    case DDX_RINGMOD_WAVEFORM:      settings.waveform = static_cast<DdsWaveform>(std::clamp(static_cast<int>(std::lround(value)), 0, 2)); break;
+    case DDX_RINGMOD_BYPASS:        settings.bypass = value > 0.5f; break;
+    case DDX_RINGMOD_AUDIO_RANGE:   settings.audioRange = value > 0.5f; break;
+    default: return;
+    }
+
+    batch->batch.setVoice(voice, settings);
+}
+
+void ddx_ringmod_batch_reset_voice(DdxRingModBatch* batch, int voice)
+{
+    if (batch != nullptr && batch->prepared)
+        batch->batch.resetVoice(voice);
+}
+
+void ddx_ringmod_batch_process(DdxRingModBatch* batch, float* const* channels, int numVoices, int numSamples)
+{
+    if (batch == nullptr || ! batch->prepared)
+        return;
+
+    batch->batch.process(channels, numVoices, numSamples);
+}
@@ -0,0 +1,134 @@
+/*
+  DDX3216 Ring Modulator Plugin - C API
+  A plain C interface to RingModEngine (and RingModVoiceBatch) for hosts,
+  games and other non-JUCE code. Values are in the plugin's parameter units.
+
+  Threading: create, prepare and destroy allocate; everything else is
+  realtime-safe, but calls on one handle must not overlap. Processing
+  leaves the FPU's denormal handling to the caller, as plugins do.
+*/
+
+#ifndef DDX_RINGMOD_CAPI_H
+#define DDX_RINGMOD_CAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct DdxRingMod DdxRingMod;
+
+typedef enum DdxRingModParam
+{
+    DDX_RINGMOD_RATE,               /* 0-1 across the range */
+    DDX_RINGMOD_BLEND,              /* 0 clean to 1 full modulation */
+    DDX_RINGMOD_WAVEFORM,           /* 0 sine, 1 triangle, 2 square */
+    DDX_RINGMOD_BYPASS,             /* 0 or 1, fades through the blend */
+    DDX_RINGMOD_SIMD,               /* 0 authentic tables, 1 polynomial kernels */
+    DDX_RINGMOD_AUDIO_RANGE,        /* 0 LFO 0.5-20 Hz, 1 audio 20 Hz-5 kHz */
+    DDX_RINGMOD_OVERSAMPLING,       /* 0 off, 1 2x, 2 4x, 3 8x */
+    DDX_RINGMOD_SPREAD,             /* 0-1 carrier phase fan across channels */
+    DDX_RINGMOD_CARRIERS,           /* 1-16 */
+    DDX_RINGMOD_MIDI,               /* 0 or 1: notes set the carrier */
+    DDX_RINGMOD_GLIDE,              /* ms */
+    DDX_RINGMOD_BEND_RANGE,         /* semitones */
+    DDX_RINGMOD_SIDECHAIN,          /* 0 oscillator, 1 sidechain carrier */
+    DDX_RINGMOD_DYNAMICS,           /* 0 or 1 */
+    DDX_RINGMOD_ENV_ATTACK,         /* ms */
+    DDX_RINGMOD_ENV_RELEASE,        /* ms */
+    DDX_RINGMOD_ENV_RANGE,          /* dB */
+    DDX_RINGMOD_ENV_TO_RATE,        /* octaves */
+    DDX_RINGMOD_ENV_TO_BLEND,       /* -1 to 1 */
+    DDX_RINGMOD_EMULATION           /* 0 off, 1 SHARC 32-bit float, 2 SHARC 40-bit extended */
+} DdxRingModParam;
+
+typedef enum DdxRingModCarrierParam
+{
+    DDX_RINGMOD_CARRIER_RATIO,      /* of the main carrier's frequency */
+    DDX_RINGMOD_CARRIER_DETUNE,     /* cents */
+    DDX_RINGMOD_CARRIER_WAVEFORM,   /* 0 sine, 1 triangle, 2 square */
+    DDX_RINGMOD_CARRIER_LEVEL
+} DdxRingModCarrierParam;
+
+/* A raw MIDI message at a sample position within the block */
+typedef struct DdxRingModMidiEvent
+{
+    int32_t sample_position;
+    const uint8_t* data;
+    int32_t num_bytes;
+} DdxRingModMidiEvent;
+
+/* NULL if out of memory */
+DdxRingMod* ddx_ringmod_create(void);
+void ddx_ringmod_destroy(DdxRingMod* ringmod);
+
+/* Blocks of any length may be processed; longer ones than max_block_size
+   are split. sidechain_channels is 0, 1 or channels. Returns 0 on bad
+   arguments or out of memory, in which case processing passes audio
+   through until a prepare succeeds. */
+int ddx_ringmod_prepare(DdxRingMod* ringmod, double sample_rate, int max_block_size,
+                        int channels, int sidechain_channels);
+
+/* Taken up at the start of the next process call, smoothed where the
+   plugin smooths. Unknown parameters and carriers, and values that are
+   NaN or infinite, are ignored. */
+void ddx_ringmod_set_param(DdxRingMod* ringmod, DdxRingModParam param, float value);
+void ddx_ringmod_set_carrier_param(DdxRingMod* ringmod, int carrier, /* 2-16 */
+                                   DdxRingModCarrierParam param, float value);
+
+/* In place. channels[c] and sidechain[c] point at num_samples samples each;
+   sidechain may be NULL, as may midi (events in time order). */
+void ddx_ringmod_process_planar(DdxRingMod* ringmod, float* const* channels,
+                                const float* const* sidechain, int num_samples,
+                                const DdxRingModMidiEvent* midi, int num_midi_events);
+
+/* In place on frames of the prepared channel count; sidechain, if not
+   NULL, is interleaved at the prepared sidechain width */
+void ddx_ringmod_process_interleaved(DdxRingMod* ringmod, float* samples,
+                                     const float* sidechain, int num_frames,
+                                     const DdxRingModMidiEvent* midi, int num_midi_events);
+
+/* Samples the output lags the input by at the oversampling last set */
+int ddx_ringmod_get_latency(const DdxRingMod* ringmod);
+
+/* Clears the filters and moves the carrier to where it would be
+   sample_position samples after prepare. With DDX_RINGMOD_DYNAMICS on the
+   envelope restarts from rest and the skipped span is taken at the
+   unmodulated rate, so the output differs from a straight run; render from
+   the start where that matters. */
+void ddx_ringmod_seek(DdxRingMod* ringmod, int64_t sample_position);
+
+/* Voice batches: many independent single-carrier ring mods (one per
+   track, say) processed in one call. A voice takes RATE, BLEND, WAVEFORM,
+   BYPASS and AUDIO_RANGE on the polynomial shapes; other parameters are
+   ignored. */
+typedef struct DdxRingModBatch DdxRingModBatch;
+
+/* NULL if out of memory */
+DdxRingModBatch* ddx_ringmod_batch_create(void);
+void ddx_ringmod_batch_destroy(DdxRingModBatch* batch);
+
+/* Voices keep their parameters across prepares and start at phase 0,
+   settled on them. Returns 0 on bad arguments or out of memory, in which
+   case processing passes audio through until a prepare succeeds. */
+int ddx_ringmod_batch_prepare(DdxRingModBatch* batch, double sample_rate, int max_voices,
+                              int channels_per_voice);
+
+/* As ddx_ringmod_set_param, for one voice */
+void ddx_ringmod_batch_set_param(DdxRingModBatch* batch, int voice, DdxRingModParam param, float value);
+
+/* Back to phase 0, settled on the voice's parameters (a track reused) */
+void ddx_ringmod_batch_reset_voice(DdxRingModBatch* batch, int voice);
+
+/* In place, voices 0 to num_voices - 1: voice v's channel c is
+   channels[v * channels_per_voice + c], num_samples samples long */
+void ddx_ringmod_batch_process(DdxRingModBatch* batch, float* const* channels, int num_voices,
+                               int num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
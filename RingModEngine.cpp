@@ -0,0 +1,834 @@
+/*
+  DDX3216 Ring Modulator Plugin - DSP Engine Implementation
+*/
+
+#include "RingModEngine.h"
+#include <algorithm>
+#include <cmath>
+#include "SharedTables.h"
+
+namespace
+{
+    // True if every input channel is exactly zero
+    template <typename SampleType>
+    bool isSilent(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        using Isa = SimdNativeLanes<SampleType>;
+        constexpr int width = Isa::width;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const SampleType* data = channels[ch];
+            auto peak = Isa::set(SampleType(0));
+            int i = 0;
+
+            for (; i + width <= numSamples; i += width)
+                peak = Isa::max(peak, Isa::abs(Isa::load(data + i)));
+
+            alignas(64) SampleType lanes[width];
+            Isa::store(lanes, peak);
+
+            for (const auto lane : lanes)
+                if (lane != SampleType(0))
+                    return false;
+
+            for (; i < numSamples; ++i)
+                if (data[i] != SampleType(0))
+                    return false;
+        }
+
+        return true;
+    }
+
+    // Largest magnitude across channels over [start, start + numSamples)
+    template <typename SampleType>
+    double inputPeak(const SampleType* const* channels, int numChannels, int start, int numSamples) noexcept
+    {
+        using Isa = SimdNativeLanes<SampleType>;
+        constexpr int width = Isa::width;
+        auto peak = Isa::set(SampleType(0));
+        SampleType tail = 0;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const SampleType* data = channels[ch] + start;
+            int i = 0;
+
+            for (; i + width <= numSamples; i += width)
+                peak = Isa::max(peak, Isa::abs(Isa::load(data + i)));
+
+            for (; i < numSamples; ++i)
+                tail = std::max(tail, std::abs(data[i]));
+        }
+
+        alignas(64) SampleType lanes[width];
+        Isa::store(lanes, peak);
+
+        for (const auto lane : lanes)
+            tail = std::max(tail, lane);
+
+        return static_cast<double>(tail);
+    }
+}
+
+//==============================================================================
+RingModEngine::RingModEngine()
+    : RingModEngine(getSupportedSimdLevel())
+{
+}
+
+RingModEngine::RingModEngine(SimdLevel level)
+    : waveTables(SharedTables::get<DdsWaveTables>()),
+      simdLevel(level)
+{
+}
+
+void RingModEngine::prepare(double sampleRate, int maxBlockSize, int numChannels, int numSidechainChannels,
+                            bool useDoublePrecision)
+{
+    currentSampleRate = sampleRate;
+    doublePrecision = useDoublePrecision;
+    oscillator.prepare(sampleRate);
+
+    // 20ms parameter smoothing, starting settled on the current values
+    smoothingSamples = static_cast<int>(std::lround(sampleRate * 0.02));
+    phaseIncRamp.setRampLength(smoothingSamples);
+    blendRamp.setRampLength(smoothingSamples);
+    spreadRamp.setRampLength(smoothingSamples);
+    settleParameters();
+    envelopeClock = 0;
+
+    // Larger blocks are processed in chunks of this size (at least 64,
+    // which the spread kernels need to split the scratch three ways)
+    numChannels = std::max(numChannels, 1);
+    const int stages = std::clamp(settings.oversamplingStages, 0, PolyphaseOversampler<float>::maxStages);
+    channelPhaseOffsets.assign(static_cast<size_t>(numChannels), 0);
+    carrierPhases.fill(0);
+
+    // The sidechain is mono or as wide as the main output
+    const int sidechainChannels = std::max(numSidechainChannels, 1);
+
+    if (doublePrecision)
+    {
+        modulatorBufferDouble.allocate(std::max(maxBlockSize, 64));
+        oversamplerDouble.prepare(numChannels, maxBlockSize, simdLevel);
+        oversamplerDouble.setNumStages(stages);
+        oversamplerDouble.reset();
+        sidechainOversamplerDouble.prepare(sidechainChannels, maxBlockSize, simdLevel);
+        sidechainOversamplerDouble.setNumStages(stages);
+        sidechainOversamplerDouble.reset();
+        sidechainCarriersDouble.assign(static_cast<size_t>(std::max(numChannels, 2)), nullptr);
+    }
+    else
+    {
+        modulatorBuffer.allocate(std::max(maxBlockSize, 64));
+        oversampler.prepare(numChannels, maxBlockSize, simdLevel);
+        oversampler.setNumStages(stages);
+        oversampler.reset();
+        sidechainOversampler.prepare(sidechainChannels, maxBlockSize, simdLevel);
+        sidechainOversampler.setNumStages(stages);
+        sidechainOversampler.reset();
+        sidechainCarriers.assign(static_cast<size_t>(std::max(numChannels, 2)), nullptr);
+    }
+
+    preparedChannels = numChannels;
+    preparedSidechainChannels = sidechainChannels;
+    latencySamples = PolyphaseOversampler<float>::getLatencySamples(stages);
+
+    // Filters were just cleared, so silence can skip them straight away
+    silentSamples = silenceSettleSamples;
+}
+
+//==============================================================================
+double RingModEngine::rateToPhaseIncrement(float rate, bool audioRange, double sampleRate) noexcept
+{
+    // LFO: map rate (0-1) to frequency (0.5-20Hz) as per SHARC code.
+    // Audio: exponential 20Hz-5kHz, kept below Nyquist at low sample rates.
+    // Left unrounded: the 64-bit master phase keeps the fraction.
+    double freq = 0.5 + 19.5 * static_cast<double>(rate);
+
+    if (audioRange)
+        freq = std::min(20.0 * std::pow(250.0, static_cast<double>(rate)), sampleRate * 0.45);
+
+    return freq / sampleRate * 4294967296.0;
+}
+
+double RingModEngine::getTargetBlend() const noexcept
+{
+    // Bypass fades the carrier out through the blend ramp
+    return settings.bypass ? 0.0 : static_cast<double>(settings.blend);
+}
+
+double RingModEngine::getTargetIncrement() const noexcept
+{
+    if (midiNote < 0)
+        return rateToPhaseIncrement(settings.rate, settings.audioRange, currentSampleRate);
+
+    // Equal temperament, A4 = 440 Hz, held below Nyquist like the audio range
+    const double semitones = midiNote - 69 + pitchBend * bendSemitones;
+    const double freq = std::min(440.0 * std::exp2(semitones / 12.0), currentSampleRate * 0.45);
+    return freq / currentSampleRate * 4294967296.0;
+}
+
+void RingModEngine::settleParameters() noexcept
+{
+    phaseIncRamp.reset(getTargetIncrement());
+    blendRamp.reset(getTargetBlend());
+    spreadRamp.reset(settings.spread);
+
+    envelope = 0.0;
+    intervalPeak = -1.0;
+    rateModulation = rateModulationTarget = 1.0;
+    depthModulation = depthModulationTarget = 1.0;
+}
+
+void RingModEngine::seekTo(int64_t samplePosition) noexcept
+{
+    settleParameters();
+    oversampler.reset();
+    oversamplerDouble.reset();
+    sidechainOversampler.reset();
+    sidechainOversamplerDouble.reset();
+    silentSamples = silenceSettleSamples;
+
+    // Same per-sample increment the kernels advance by, so the master
+    // phase lands exactly where a straight run would have left it
+    const int factor = doublePrecision ? oversamplerDouble.getFactor() : oversampler.getFactor();
+    integerPhase = settings.emulation != 0;
+    const double inc = wholeIncrement(phaseIncRamp.getCurrent() * (1.0 / factor));
+    oscillator.reset();
+    oscillator.advance(samplePosition * factor, inc, 0.0);
+
+    // The envelope grid lines up with a straight run's; the envelope
+    // itself starts from rest (see the header)
+    envelopeClock = samplePosition;
+
+    // Bank carriers run on whole 32-bit increments, so n steps is exact
+    currentWaveform = settings.waveform;
+    updateCarrierBank();
+
+    if (numCarriers > 1)
+    {
+        loadCarrierBank(inc, 0.0);
+
+        for (int slot = 0; slot < carrierBank.numCarriers; ++slot)
+            carrierPhases[static_cast<size_t>(bankCarrier[static_cast<size_t>(slot)])] =
+                static_cast<uint32_t>(static_cast<uint64_t>(samplePosition * factor) * carrierBank.phaseInc[slot]);
+    }
+}
+
+//==============================================================================
+void RingModEngine::updateCarrierBank() noexcept
+{
+    numCarriers = std::clamp(settings.numCarriers, 1, CarrierBank::maxCarriers);
+
+    if (numCarriers == 1)
+        return;
+
+    double multipliers[CarrierBank::maxCarriers];
+    int shapes[CarrierBank::maxCarriers];
+    float levels[CarrierBank::maxCarriers];
+
+    multipliers[0] = 1.0;
+    shapes[0] = static_cast<int>(currentWaveform);
+    levels[0] = 1.0f;
+    float total = levels[0];
+
+    for (int c = 1; c < numCarriers; ++c)
+    {
+        const auto& carrier = settings.extraCarriers[static_cast<size_t>(c - 1)];
+        const double cents = carrier.detune;
+        multipliers[c] = carrier.ratio * std::exp2(cents / 1200.0);
+        shapes[c] = static_cast<int>(carrier.waveform);
+        levels[c] = carrier.level;
+        total += levels[c];
+    }
+
+    // The sum stays within +-1, like a single carrier
+    const float norm = 1.0f / std::max(1.0f, total);
+    int slot = 0;
+
+    for (int shape = 0; shape < 3; ++shape)
+    {
+        for (int c = 0; c < numCarriers; ++c)
+        {
+            if (shapes[c] != shape)
+                continue;
+
+            bankCarrier[static_cast<size_t>(slot)] = c;
+            bankMultiplier[static_cast<size_t>(slot)] = multipliers[c];
+            carrierBank.level[slot] = levels[c] * norm;
+            ++slot;
+        }
+
+        carrierBank.waveformEnd[shape] = slot;
+    }
+
+    carrierBank.numCarriers = slot;
+}
+
+void RingModEngine::loadCarrierBank(double inc, double incStep) noexcept
+{
+    // Carriers pushed past 0.45 of the (oversampled) rate are held there
+    constexpr double maxInc = 0.45 * 4294967296.0;
+
+    for (int slot = 0; slot < carrierBank.numCarriers; ++slot)
+    {
+        const int carrier = bankCarrier[static_cast<size_t>(slot)];
+        const double multiplier = bankMultiplier[static_cast<size_t>(slot)];
+        const double carrierInc = inc * multiplier;
+
+        carrierBank.phase[slot] = carrier == 0 ? oscillator.getPhase() : carrierPhases[static_cast<size_t>(carrier)];
+        carrierBank.phaseInc[slot] = static_cast<uint32_t>(std::llround(std::min(carrierInc, maxInc)));
+        carrierBank.phaseIncStep[slot] = carrierInc > maxInc ? 0 : static_cast<int32_t>(std::llround(incStep * multiplier));
+    }
+}
+
+void RingModEngine::storeCarrierBank() noexcept
+{
+    // Carrier 0 follows the exact master phase instead
+    for (int slot = 0; slot < carrierBank.numCarriers; ++slot)
+        if (const int carrier = bankCarrier[static_cast<size_t>(slot)]; carrier != 0)
+            carrierPhases[static_cast<size_t>(carrier)] = carrierBank.phase[slot];
+}
+
+//==============================================================================
+void RingModEngine::process(const RingModIO<float>& io) noexcept
+{
+    processBlock(io);
+}
+
+void RingModEngine::process(const RingModIO<double>& io) noexcept
+{
+    processBlock(io);
+}
+
+template <typename SampleType>
+void RingModEngine::processBlock(const RingModIO<SampleType>& io) noexcept
+{
+    auto& scratch = [this]() -> SimdAlignedBuffer<SampleType>&
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return modulatorBufferDouble;
+        else
+            return modulatorBuffer;
+    }();
+
+    auto& resampler = [this]() -> PolyphaseOversampler<SampleType>&
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return oversamplerDouble;
+        else
+            return oversampler;
+    }();
+
+    auto& sidechainResampler = [this]() -> PolyphaseOversampler<SampleType>&
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return sidechainOversamplerDouble;
+        else
+            return sidechainOversampler;
+    }();
+
+    auto& sidechainCarrierPointers = [this]() -> std::vector<const SampleType*>&
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return sidechainCarriersDouble;
+        else
+            return sidechainCarriers;
+    }();
+
+    // Never prepared for this precision, or more channels than prepared for
+    const int numSamples = io.numSamples;
+    const int numChannels = io.numOutputs;
+
+    if (scratch.size() == 0 || numChannels > preparedChannels || numSamples <= 0)
+        return;
+
+    // Mono in, stereo out: channel 1 arrives empty and gets channel 0's
+    // result, computed once
+    SampleType* const* channels = io.channels;
+    const int totalInputs = io.numInputs;
+    const bool monoToStereo = totalInputs == 1 && numChannels == 2;
+
+    // Sidechain carrier; with none connected it leaves only the dry signal
+    const bool sidechainMode = settings.sidechain;
+    const int sidechainChannels = sidechainMode && io.sidechain != nullptr
+                                    ? std::min(io.numSidechain, preparedSidechainChannels) : 0;
+
+    // Block-rate choices
+    currentWaveform = settings.waveform;
+    const auto path = settings.emulation == 1 ? RingModPath::Sharc32
+                    : settings.emulation == 2 ? RingModPath::Sharc40
+                    : settings.simd ? RingModPath::SIMD : RingModPath::Scalar;
+    integerPhase = settings.emulation != 0;
+    updateCarrierBank();
+
+    // MIDI events are applied as the carrier loops reach them. With MIDI
+    // off, the carrier goes back to the rate setting.
+    if (settings.midi)
+    {
+        midiEvents = io.numMidiEvents > 0 ? io.midi : nullptr;
+        midiEventsEnd = midiEvents != nullptr ? io.midi + io.numMidiEvents : nullptr;
+        glideSamples = static_cast<int>(std::lround(settings.glideMs * 0.001 * currentSampleRate));
+        bendSemitones = settings.bendRange;
+    }
+    else
+    {
+        midiEvents = midiEventsEnd = nullptr;
+        midiNote = -1;
+        numHeldNotes = 0;
+        pitchBend = 0.0;
+    }
+
+    // Dynamics settings; the follower itself runs as the carrier loops go
+    dynamicsActive = settings.dynamics && ! sidechainMode;
+    attackSamples = std::max(1.0, settings.envAttackMs * 0.001 * currentSampleRate);
+    releaseSamples = std::max(1.0, settings.envReleaseMs * 0.001 * currentSampleRate);
+    envelopeRange = settings.envRangeDb;
+    envelopeToRate = settings.envToRate;
+    envelopeToBlend = settings.envToBlend;
+
+    // Smoothed parameters. A glide already under way keeps its own length:
+    // setting the target it is heading for changes nothing.
+    phaseIncRamp.setRampLength(smoothingSamples);
+    phaseIncRamp.setTarget(getTargetIncrement());
+    blendRamp.setTarget(getTargetBlend());
+    spreadRamp.setTarget(settings.spread);
+
+    // Factor changes take effect here
+    const int stages = std::clamp(settings.oversamplingStages, 0, PolyphaseOversampler<SampleType>::maxStages);
+    if (stages != resampler.getNumStages())
+    {
+        resampler.setNumStages(stages);
+        sidechainResampler.setNumStages(stages);
+        latencySamples = PolyphaseOversampler<SampleType>::getLatencySamples(stages);
+    }
+
+    // Per-channel carrier offsets (single carrier only); spread is smoothed
+    // at block rate
+    const double spread = spreadRamp.getCurrent();
+    const bool spreading = spread > 0.0 && ! sidechainMode && numCarriers == 1 && numChannels > 1
+                           && numChannels <= static_cast<int>(channelPhaseOffsets.size());
+    spreadRamp.advance(numSamples);
+
+    if (spreading)
+        for (int ch = 0; ch < numChannels; ++ch)
+            channelPhaseOffsets[static_cast<size_t>(ch)] =
+                static_cast<uint32_t>(std::llround(spread * ch / numChannels * 4294967296.0));
+
+    // Fast paths. Silent input stays silent once the oversampling filters
+    // hold nothing but zeros, and a fully faded-out carrier (zero blend or
+    // bypass) leaves the input untouched. The carrier and ramps still move
+    // on exactly as if the block had been processed, so resuming is seamless;
+    // bypass and blend changes fade through the blend ramp.
+    const bool silent = isSilent(channels, totalInputs, numSamples);
+    const bool drained = stages == 0 || silentSamples >= silenceSettleSamples;
+    silentSamples = silent ? std::min(silentSamples + numSamples, silenceSettleSamples) : 0;
+
+    const bool mixedOut = ! blendRamp.isRamping() && blendRamp.getCurrent() == 0.0;
+
+    if ((silent && drained) || (mixedOut && stages == 0))
+    {
+        // The follower hears the input the carrier is skipped over
+        if (silent)
+            skipCarrier(0, numSamples, resampler.getFactor(), [](int, int) { return 0.0; });
+        else
+            skipCarrier(0, numSamples, 1, [&](int start, int length)
+                        { return inputPeak(channels, totalInputs, start, length); });
+
+        applyMidiEvents(numSamples, 0);
+        midiEvents = midiEventsEnd = nullptr;
+
+        if (monoToStereo)
+            std::copy(channels[0], channels[0] + numSamples, channels[1]);
+
+        return;
+    }
+
+    // Channel 1 needs the input itself whenever it won't simply receive
+    // channel 0's result: its own carrier, no carrier, or the bank kernel
+    // (which applies one modulator to every channel it is given). The
+    // sidechain kernel reads channel 0 for both, and must: the sidechain's
+    // first channel may share storage with output channel 1.
+    const bool sharedInput = monoToStereo && ! mixedOut
+                             && (sidechainMode ? sidechainChannels > 0 : ! spreading && numCarriers == 1);
+
+    if (monoToStereo && ! sharedInput)
+        std::copy(channels[0], channels[0] + numSamples, channels[1]);
+
+    const auto layout = getRingModChannels(numChannels, sharedInput, spreading);
+    const int numInputs = sharedInput ? 1 : numChannels;
+
+    RingModBlock<SampleType> block;
+    block.numChannels = numChannels;
+    block.table = waveTables->getTable(currentWaveform);
+    block.modulator = scratch.get();
+    block.modulatorSize = scratch.size();
+    block.phaseOffsets = channelPhaseOffsets.data();
+
+    // Output channel ch takes sidechain channel ch, wrapping (a mono
+    // sidechain feeds every channel)
+    auto mapSidechain = [&](const SampleType* const* source) -> const SampleType* const*
+    {
+        if (sidechainChannels == 0)
+            return nullptr;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            sidechainCarrierPointers[static_cast<size_t>(ch)] = source[ch % sidechainChannels];
+
+        return sidechainCarrierPointers.data();
+    };
+
+    if (stages == 0)
+    {
+        block.channels = channels;
+
+        if (sidechainMode)
+            renderSidechain(block, mapSidechain(io.sidechain), 0, numSamples, 1, path, layout);
+        else
+            renderCarrier(block, 0, numSamples, 1, path, layout);
+    }
+    else
+    {
+        // Oversampled: up, carrier at the higher rate, back down, in chunks
+        // the oversampler was prepared for. With the carrier faded out only
+        // the filters run, keeping the latency and filter state continuous.
+        const int factor = resampler.getFactor();
+
+        for (int start = 0; start < numSamples; start += resampler.getMaxBlockSize())
+        {
+            const int chunk = std::min(numSamples - start, resampler.getMaxBlockSize());
+
+            block.channels = resampler.processUp(channels, numInputs, start, chunk);
+
+            if (mixedOut)
+            {
+                skipCarrier(start, chunk, factor, [&](int offset, int length)
+                            { return inputPeak(block.channels, numInputs, offset * factor, length * factor); });
+            }
+            else if (sidechainMode)
+            {
+                // Upsampled with the same filters, so it lines up with the input
+                auto* const* sidechain = sidechainChannels > 0
+                    ? sidechainResampler.processUp(io.sidechain, sidechainChannels, start, chunk)
+                    : nullptr;
+
+                renderSidechain(block, mapSidechain(sidechain), start, chunk, factor, path, layout);
+            }
+            else
+            {
+                renderCarrier(block, start, chunk, factor, path, layout);
+            }
+
+            resampler.processDown(channels, numChannels, start, chunk);
+        }
+    }
+
+    // Events stamped at or past the block end (outside the host contract,
+    // but some send them) still count
+    applyMidiEvents(numSamples, 0);
+    midiEvents = midiEventsEnd = nullptr;
+}
+
+template <typename SampleType>
+void RingModEngine::renderCarrier(RingModBlock<SampleType>& block, int position, int numSamples, int factor,
+                                  RingModPath path, RingModChannels layout) noexcept
+{
+    // Ramps count base-rate samples; at factor x the increment and blend
+    // move 1/factor as far per sample and the increment's slope 1/factor^2
+    const double incScale = 1.0 / factor;
+    const double slopeScale = incScale * incScale;
+
+    // While anything moves, run the ramped kernel over segments with a
+    // constant slope; everything after that goes through the
+    // constant-parameter kernel. With dynamics on, the kernels also measure
+    // the input peak, in the same pass, for the envelope follower.
+    SampleType peak = 0;
+    block.peak = &peak;
+
+    for (int start = 0; start < numSamples;)
+    {
+        const auto segment = nextCarrierSegment(position + start, numSamples - start);
+        const double inc = wholeIncrement(segment.inc * incScale);
+        const double incStep = wholeIncrement(segment.incStep * slopeScale);
+
+        block.startSample = start * factor;
+        block.numSamples = segment.length * factor;
+        block.blend = static_cast<SampleType>(segment.blend);
+        block.blendStep = static_cast<SampleType>(segment.blendStep * incScale);
+        block.phaseIncStep = static_cast<int32_t>(std::llround(incStep));
+        peak = 0;
+
+        // The kernel runs on the rounded 32-bit phase; the master phase then
+        // moves on by the exact amount so the rounding never accumulates
+        if (numCarriers > 1)
+        {
+            loadCarrierBank(inc, incStep);
+            getCarrierBankKernel<SampleType>(path, simdLevel, segment.ramped, dynamicsActive)(block, carrierBank);
+            storeCarrierBank();
+        }
+        else
+        {
+            auto kernel = getRingModKernel<SampleType>(path, currentWaveform, layout, simdLevel,
+                                                       segment.ramped, dynamicsActive);
+            kernel(block, oscillator.getPhase(), static_cast<uint32_t>(std::llround(inc)));
+        }
+
+        oscillator.advance(block.numSamples, inc, incStep);
+        finishCarrierSegment(segment.length, static_cast<double>(peak));
+        start += segment.length;
+    }
+
+    block.peak = nullptr;
+}
+
+template <typename SampleType>
+void RingModEngine::renderSidechain(RingModBlock<SampleType>& block, const SampleType* const* carriers,
+                                    int position, int numSamples, int factor, RingModPath path,
+                                    RingModChannels layout) noexcept
+{
+    // Only the blend ramp matters here: one ramped run while it lasts,
+    // then one constant run
+    const bool connected = carriers != nullptr;
+    const int ramped = std::min(numSamples, blendRamp.getRemainingSamples());
+
+    if (ramped > 0)
+    {
+        block.startSample = 0;
+        block.numSamples = ramped * factor;
+        block.blend = static_cast<SampleType>(blendRamp.getCurrent());
+        block.blendStep = static_cast<SampleType>(blendRamp.getStep() / factor);
+        getSidechainKernel<SampleType>(path, layout, simdLevel, connected, true)(block, carriers);
+    }
+
+    if (ramped < numSamples)
+    {
+        block.startSample = ramped * factor;
+        block.numSamples = (numSamples - ramped) * factor;
+        block.blend = static_cast<SampleType>(blendRamp.getTarget());
+        getSidechainKernel<SampleType>(path, layout, simdLevel, connected, false)(block, carriers);
+    }
+
+    // Dynamics is off in sidechain mode, so the envelope has nothing to hear
+    skipCarrier(position, numSamples, factor, [](int, int) { return -1.0; });
+}
+
+template <typename PeakFunction>
+void RingModEngine::skipCarrier(int position, int numSamples, int factor, PeakFunction&& measurePeak) noexcept
+{
+    // The same segments and phase arithmetic as renderCarrier, minus the
+    // kernels, so the master phase lands exactly where processing would
+    // have left it
+    const double incScale = 1.0 / factor;
+    const double slopeScale = incScale * incScale;
+
+    for (int start = 0; start < numSamples;)
+    {
+        const auto segment = nextCarrierSegment(position + start, numSamples - start);
+        const double inc = wholeIncrement(segment.inc * incScale);
+        const double incStep = wholeIncrement(segment.incStep * slopeScale);
+        const int steps = segment.length * factor;
+
+        // Bank carriers: n steps of phase += inc, inc += incStep, mod 2^32
+        if (numCarriers > 1)
+        {
+            loadCarrierBank(inc, incStep);
+            const auto triangular = static_cast<uint32_t>(static_cast<uint64_t>(steps) * static_cast<uint64_t>(steps - 1) / 2);
+
+            for (int slot = 0; slot < carrierBank.numCarriers; ++slot)
+                carrierBank.phase[slot] += static_cast<uint32_t>(steps) * carrierBank.phaseInc[slot]
+                                         + static_cast<uint32_t>(carrierBank.phaseIncStep[slot]) * triangular;
+
+            storeCarrierBank();
+        }
+
+        oscillator.advance(steps, inc, incStep);
+
+        finishCarrierSegment(segment.length, dynamicsActive ? measurePeak(start, segment.length) : 0.0);
+        start += segment.length;
+    }
+}
+
+RingModEngine::CarrierSegment RingModEngine::nextCarrierSegment(int position, int maxSamples) noexcept
+{
+    // Up to the next MIDI event (applied first) and the end of the
+    // shortest active ramp, so the ramps' slopes are constant across it
+    int length = applyMidiEvents(position, maxSamples);
+
+    if (phaseIncRamp.isRamping())
+        length = std::min(length, phaseIncRamp.getRemainingSamples());
+
+    if (blendRamp.isRamping())
+        length = std::min(length, blendRamp.getRemainingSamples());
+
+    CarrierSegment segment { length, phaseIncRamp.getCurrent(), phaseIncRamp.getStep(),
+                             blendRamp.getCurrent(), blendRamp.getStep(),
+                             phaseIncRamp.isRamping() || blendRamp.isRamping() };
+
+    // Envelope modulation, also while it returns to neutral after dynamics
+    // is switched off. Envelope intervals sit on a grid of absolute sample
+    // positions, so block sizes never move them. Across an interval the
+    // factors move linearly from the last targets to the latest; their
+    // product with the ramps is taken at the segment's ends, a function of
+    // position alone, and linearised between, which keeps both continuous.
+    if (dynamicsActive || rateModulation != 1.0 || depthModulation != 1.0
+        || rateModulationTarget != 1.0 || depthModulationTarget != 1.0)
+    {
+        const int elapsed = static_cast<int>(envelopeClock % envelopeInterval);
+        segment.length = std::min(segment.length, envelopeInterval - elapsed);
+
+        auto across = [](double from, double to, int offset)
+        {
+            return from + (to - from) * (offset / static_cast<double>(envelopeInterval));
+        };
+
+        constexpr double maxIncrement = 0.45 * 4294967296.0;
+        const double n = segment.length;
+        const double incEnd = std::min((segment.inc + segment.incStep * n)
+                                           * across(rateModulation, rateModulationTarget, elapsed + segment.length),
+                                       maxIncrement);
+        const double blendEnd = (segment.blend + segment.blendStep * n)
+                              * across(depthModulation, depthModulationTarget, elapsed + segment.length);
+
+        segment.inc = std::min(segment.inc * across(rateModulation, rateModulationTarget, elapsed), maxIncrement);
+        segment.incStep = (incEnd - segment.inc) / n;
+        segment.blend *= across(depthModulation, depthModulationTarget, elapsed);
+        segment.blendStep = (blendEnd - segment.blend) / n;
+        segment.ramped = segment.ramped || rateModulation != rateModulationTarget
+                         || depthModulation != depthModulationTarget;
+    }
+
+    return segment;
+}
+
+void RingModEngine::finishCarrierSegment(int length, double peak) noexcept
+{
+    phaseIncRamp.advance(length);
+    blendRamp.advance(length);
+
+    // Peaks gather until the next grid point; only there does the
+    // follower move and the factors take up new targets
+    envelopeClock += length;
+
+    if (dynamicsActive)
+        intervalPeak = std::max(intervalPeak, peak);
+
+    if (envelopeClock % envelopeInterval != 0)
+        return;
+
+    const double measured = intervalPeak;
+    intervalPeak = -1.0;
+    rateModulation = rateModulationTarget;
+    depthModulation = depthModulationTarget;
+
+    if (! dynamicsActive)
+    {
+        envelope = 0.0;
+        rateModulationTarget = depthModulationTarget = 1.0;
+        return;
+    }
+
+    // Nothing heard this interval: the envelope holds
+    if (measured < 0.0)
+        return;
+
+    // One-pole follower, attack while the peak is above it
+    const double time = measured > envelope ? attackSamples : releaseSamples;
+    envelope = measured + (envelope - measured) * std::exp(-envelopeInterval / time);
+
+    // 0 at the bottom of the range (or below), 1 at full scale
+    const double decibels = envelope > 0.0 ? 20.0 * std::log10(envelope) : -envelopeRange;
+    const double level = std::clamp(1.0 + decibels / envelopeRange, 0.0, 1.0);
+
+    rateModulationTarget = std::exp2(envelopeToRate * level);
+    depthModulationTarget = envelopeToBlend >= 0.0 ? 1.0 - envelopeToBlend * (1.0 - level)
+                                                   : 1.0 + envelopeToBlend * level;
+}
+
+//==============================================================================
+int RingModEngine::applyMidiEvents(int position, int maxSamples) noexcept
+{
+    for (; midiEvents != midiEventsEnd; ++midiEvents)
+    {
+        if (midiEvents->samplePosition > position)
+            return std::min(maxSamples, midiEvents->samplePosition - position);
+
+        handleMidiEvent(midiEvents->data, midiEvents->numBytes);
+    }
+
+    return maxSamples;
+}
+
+void RingModEngine::handleMidiEvent(const uint8_t* data, int numBytes) noexcept
+{
+    // Raw bytes; every channel, last-note priority
+    if (data == nullptr || numBytes < 3)
+        return;
+
+    const int status = data[0] & 0xf0;
+    const int data1 = data[1];
+    const int data2 = data[2];
+
+    auto release = [this](int note)
+    {
+        for (int i = 0; i < numHeldNotes; ++i)
+        {
+            if (heldNotes[static_cast<size_t>(i)] == note)
+            {
+                std::copy(heldNotes.begin() + i + 1, heldNotes.begin() + numHeldNotes, heldNotes.begin() + i);
+                --numHeldNotes;
+                return;
+            }
+        }
+    };
+
+    if (status == 0x90 && data2 > 0)
+    {
+        // Note on; past the limit, the oldest held note is forgotten
+        release(data1);
+
+        if (numHeldNotes == maxHeldNotes)
+            release(heldNotes[0]);
+
+        heldNotes[static_cast<size_t>(numHeldNotes++)] = data1;
+        midiNote = data1;
+        retuneCarrier(glideSamples);
+    }
+    else if (status == 0x80 || status == 0x90)
+    {
+        // Note off: back to the latest note still held. The last one
+        // released keeps sounding, as the carrier never stops.
+        release(data1);
+
+        if (data1 == midiNote && numHeldNotes > 0)
+        {
+            midiNote = heldNotes[static_cast<size_t>(numHeldNotes - 1)];
+            retuneCarrier(glideSamples);
+        }
+    }
+    else if (status == 0xe0)
+    {
+        pitchBend = ((data2 << 7 | data1) - 8192) / 8192.0;
+
+        // Bent from where the carrier is; a glide under way keeps its end
+        // time and arrives at the bent note instead
+        if (midiNote >= 0)
+            retuneCarrier(std::max(smoothingSamples, phaseIncRamp.getRemainingSamples()));
+    }
+    else if (status == 0xb0 && (data1 == 120 || data1 == 123))
+    {
+        // All sound / all notes off: nothing held, and the carrier goes
+        // back to the rate setting as before the first note
+        heldNotes = {};
+        numHeldNotes = 0;
+        midiNote = -1;
+        retuneCarrier(smoothingSamples);
+    }
+}
+
+void RingModEngine::retuneCarrier(int rampLength) noexcept
+{
+    phaseIncRamp.setRampLength(rampLength);
+    phaseIncRamp.setTarget(getTargetIncrement());
+}
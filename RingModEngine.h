@@ -0,0 +1,291 @@
+/*
+  DDX3216 Ring Modulator Plugin - DSP Engine
+  Everything that makes the sound - carrier oscillator, smoothing, MIDI
+  and envelope control, carrier bank, sidechain, oversampling and the
+  kernel dispatch - with no JUCE dependency. The plugin is a thin wrapper
+  around it; RingModCApi.h exposes it to C for embedding elsewhere.
+
+  Library sources: RingModEngine.cpp, RingModVoiceBatch.cpp, RingModCApi.cpp
+  and the kernel units RingModKernels.cpp, RingModKernelsAVX2.cpp,
+  RingModKernelsAVX512.cpp.
+*/
+
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "DdsOscillator.h"
+#include "RingModKernels.h"
+#include "RingModSimd.h"
+#include "ParameterRamp.h"
+#include "PolyphaseOversampler.h"
+
+//==============================================================================
+// Every setting as a plain value, in the plugin's parameter units
+//==============================================================================
+struct RingModSettings
+{
+    float rate = 0.3f;                 // 0-1 across the range
+    float blend = 0.5f;                // 0 clean to 1 full modulation
+    DdsWaveform waveform = DdsWaveform::Sine;
+    bool bypass = false;               // fades out through the blend
+    bool simd = false;                 // polynomial kernels instead of the authentic tables
+    bool audioRange = false;           // 20 Hz-5 kHz instead of the 0.5-20 Hz LFO
+    int emulation = 0;                 // 0 off, 1 SHARC 32-bit float, 2 SHARC 40-bit extended
+    int oversamplingStages = 0;        // 0 off, 1 2x, 2 4x, 3 8x
+    float spread = 0.0f;               // 0-1 carrier phase fan across channels
+
+    // Carrier bank: carriers 2 to numCarriers join the main one
+    struct ExtraCarrier
+    {
+        float ratio = 2.0f;            // of the main carrier's frequency
+        float detune = 0.0f;           // cents
+        DdsWaveform waveform = DdsWaveform::Sine;
+        float level = 0.5f;
+    };
+
+    int numCarriers = 1;
+    std::array<ExtraCarrier, CarrierBank::maxCarriers - 1> extraCarriers {};
+
+    // MIDI carrier
+    bool midi = false;
+    float glideMs = 50.0f;
+    float bendRange = 2.0f;            // semitones
+
+    bool sidechain = false;            // carrier taken from the sidechain input
+
+    // Dynamics (oscillator carrier only)
+    bool dynamics = false;
+    float envAttackMs = 5.0f;
+    float envReleaseMs = 150.0f;
+    float envRangeDb = 48.0f;
+    float envToRate = 1.0f;            // octaves
+    float envToBlend = 0.5f;           // -1 to 1
+
+    RingModSettings() noexcept
+    {
+        for (size_t c = 0; c < extraCarriers.size(); ++c)
+            extraCarriers[c].ratio = static_cast<float>(c + 2);
+    }
+};
+
+// A raw MIDI message at a sample position within the block
+struct RingModMidiEvent
+{
+    int samplePosition;
+    const uint8_t* data;
+    int numBytes;
+};
+
+// One block of audio, processed in place. channels[0, numInputs) hold the
+// input and all numOutputs channels receive the output; the two counts are
+// equal, or 1 in and 2 out. Sidechain channels (numSidechain 0, 1 or
+// numOutputs) are only read and may share storage with output channel 1
+// in the mono-to-stereo case. MIDI events are in time order.
+template <typename SampleType>
+struct RingModIO
+{
+    SampleType* const* channels = nullptr;
+    int numInputs = 0;
+    int numOutputs = 0;
+    const SampleType* const* sidechain = nullptr;
+    int numSidechain = 0;
+    int numSamples = 0;
+    const RingModMidiEvent* midi = nullptr;
+    int numMidiEvents = 0;
+};
+
+//==============================================================================
+class RingModEngine
+{
+public:
+    // Uses the widest kernels this build and CPU support
+    RingModEngine();
+    explicit RingModEngine(SimdLevel level);
+
+    // Not realtime-safe: sizes the buffers for blocks of up to maxBlockSize
+    // (larger blocks are processed in pieces) and channel counts, for the
+    // given precision only, and starts settled on the current settings.
+    // process leaves the audio untouched in a precision never prepared,
+    // and with more output channels than prepared for.
+    void prepare(double sampleRate, int maxBlockSize, int numChannels, int numSidechainChannels,
+                 bool doublePrecision);
+
+    // Taken up at the start of the next process call (ramped, where the
+    // plugin's parameters are ramped)
+    void setSettings(const RingModSettings& newSettings) noexcept { settings = newSettings; }
+    const RingModSettings& getSettings() const noexcept { return settings; }
+
+    // Realtime-safe: never allocates, locks or waits
+    void process(const RingModIO<float>& io) noexcept;
+    void process(const RingModIO<double>& io) noexcept;
+
+    // Clears the filters and moves the carrier to where it would be
+    // samplePosition samples after prepare, settings held constant.
+    // Dynamics can't be caught up without the audio skipped over: the
+    // envelope starts from rest and the carrier moves at its unmodulated
+    // rate, so with dynamics on the output no longer matches a straight
+    // run. Callers that need it to must render from the start instead.
+    void seekTo(int64_t samplePosition) noexcept;
+
+    // Round-trip latency of the oversampling stages the last block used
+    int getLatencySamples() const noexcept { return latencySamples; }
+
+    SimdLevel getSimdLevel() const noexcept { return simdLevel; }
+
+    // Carrier increment for a rate setting, in 2^-32 cycles per sample
+    static double rateToPhaseIncrement(float rate, bool audioRange, double sampleRate) noexcept;
+
+private:
+    using Waveform = DdsWaveform;
+
+    template <typename SampleType>
+    void processBlock(const RingModIO<SampleType>& io) noexcept;
+
+    // Runs the carrier kernels over numSamples base-rate samples of block,
+    // whose channels may be oversampled by factor; position is where the
+    // first of them falls in the block, for MIDI timing
+    template <typename SampleType>
+    void renderCarrier(RingModBlock<SampleType>& block, int position, int numSamples, int factor,
+                       RingModPath path, RingModChannels layout) noexcept;
+
+    // Sidechain mode: the input multiplied by carriers[ch] (nullptr with no
+    // sidechain connected); the oscillator keeps moving underneath so that
+    // switching back is seamless
+    template <typename SampleType>
+    void renderSidechain(RingModBlock<SampleType>& block, const SampleType* const* carriers, int position,
+                         int numSamples, int factor, RingModPath path, RingModChannels layout) noexcept;
+
+    // Moves the carrier and ramps on by numSamples without rendering.
+    // measurePeak(start, length) gives the envelope follower the input
+    // peak over those base-rate samples of the call, or -1 to hold it.
+    template <typename PeakFunction>
+    void skipCarrier(int position, int numSamples, int factor, PeakFunction&& measurePeak) noexcept;
+
+    // One stretch of the carrier with constant slopes, in base-rate units:
+    // up to the next MIDI event or ramp end (and, with dynamics, at most
+    // one envelope interval), with the envelope's modulation applied
+    struct CarrierSegment
+    {
+        int length;
+        double inc, incStep, blend, blendStep;
+        bool ramped;
+    };
+
+    CarrierSegment nextCarrierSegment(int position, int maxSamples) noexcept;
+
+    // Moves the ramps past a segment and feeds the envelope follower the
+    // input peak found in it (negative when there was nothing to measure)
+    void finishCarrierSegment(int length, double peak) noexcept;
+
+    // MIDI carrier control. Events due at position are applied, and the
+    // samples up to the next one (at most maxSamples) returned, so the
+    // carrier loops split blocks at event times and never look at MIDI
+    // inside a kernel.
+    int applyMidiEvents(int position, int maxSamples) noexcept;
+    void handleMidiEvent(const uint8_t* data, int numBytes) noexcept;
+    void retuneCarrier(int rampLength) noexcept;
+
+    // Carrier bank: settings regrouped by shape once per block, then the
+    // bank's phases and increments loaded and saved around each segment
+    void updateCarrierBank() noexcept;
+    void loadCarrierBank(double inc, double incStep) noexcept;
+    void storeCarrierBank() noexcept;
+
+    // Carrier increment the rate ramp heads for: the held MIDI note, bent,
+    // or the rate setting before any note (or with MIDI off)
+    double getTargetIncrement() const noexcept;
+
+    // Blend the ramp heads for: the setting, or 0 while bypassed
+    double getTargetBlend() const noexcept;
+
+    // Ramps jump to the current settings
+    void settleParameters() noexcept;
+
+    // Under SHARC emulation increments are whole 32-bit phase units, so the
+    // master phase steps exactly like the DSP's 32-bit accumulator
+    double wholeIncrement(double inc) const noexcept { return integerPhase ? std::round(inc) : inc; }
+
+    RingModSettings settings;
+
+    // Oscillator state
+    std::shared_ptr<const DdsWaveTables> waveTables;   // one copy per process
+    DdsOscillator oscillator;
+    double currentSampleRate = 48000.0;
+    const SimdLevel simdLevel;
+    bool doublePrecision = false;
+    bool integerPhase = false;
+    Waveform currentWaveform = Waveform::Sine;
+
+    // Automation-safe rate (in phase-increment units) and blend
+    ParameterRamp<double> phaseIncRamp;
+    ParameterRamp<double> blendRamp;
+    ParameterRamp<double> spreadRamp;
+    int smoothingSamples = 1;
+
+    // MIDI: held notes oldest first (the last one sounds), -1 before the
+    // first note or after all notes off; note changes glide, bends follow
+    // the usual smoothing or ride along a glide under way
+    static constexpr int maxHeldNotes = 16;
+    std::array<int, maxHeldNotes> heldNotes {};
+    int numHeldNotes = 0;
+    int midiNote = -1;
+    double pitchBend = 0.0;        // -1 to 1
+    double bendSemitones = 2.0;
+    int glideSamples = 1;
+    const RingModMidiEvent* midiEvents = nullptr;   // this block's, while processing
+    const RingModMidiEvent* midiEventsEnd = nullptr;
+
+    // Dynamics: the kernels report the input peak of each segment, a
+    // one-pole attack/release follower smooths it, and the level (0-1
+    // across the mapping range) sets rate and blend factors the next
+    // interval ramps to. Intervals fall every envelopeInterval base-rate
+    // samples counted from prepare (or the seek position), whatever the
+    // block sizes; segments never cross one.
+    static constexpr int envelopeInterval = 32;
+    bool dynamicsActive = false;
+    int64_t envelopeClock = 0;
+    double intervalPeak = -1.0;        // this interval's so far, -1 before any
+    double envelope = 0.0;
+    double attackSamples = 1.0, releaseSamples = 1.0;
+    double envelopeRange = 48.0;       // dB below full scale mapped to level 0
+    double envelopeToRate = 0.0;       // octaves at level 1
+    double envelopeToBlend = 0.0;      // -1 to 1
+    double rateModulation = 1.0, rateModulationTarget = 1.0;
+    double depthModulation = 1.0, depthModulationTarget = 1.0;
+
+    // Carrier rendered once per block and shared by every channel
+    SimdAlignedBuffer<float> modulatorBuffer;
+    SimdAlignedBuffer<double> modulatorBufferDouble;
+
+    // Carrier phase offset per channel (spread)
+    std::vector<uint32_t> channelPhaseOffsets;
+
+    // Multi-carrier mode. Carrier 0 is the main carrier on the master phase;
+    // the rest keep their own 32-bit phases, indexed by carrier number.
+    int numCarriers = 1;
+    CarrierBank carrierBank;
+    std::array<int, CarrierBank::maxCarriers> bankCarrier {};        // bank slot -> carrier
+    std::array<double, CarrierBank::maxCarriers> bankMultiplier {};  // bank slot -> rate multiplier
+    std::array<uint32_t, CarrierBank::maxCarriers> carrierPhases {};
+
+    // Half-band oversampling around the carrier multiply
+    PolyphaseOversampler<float> oversampler;
+    PolyphaseOversampler<double> oversamplerDouble;
+    int latencySamples = 0;
+    int preparedChannels = 0, preparedSidechainChannels = 0;
+
+    // Sidechain carrier: read in place, one pointer per output channel;
+    // oversampled alongside the main input when needed
+    PolyphaseOversampler<float> sidechainOversampler;
+    PolyphaseOversampler<double> sidechainOversamplerDouble;
+    std::vector<const float*> sidechainCarriers;
+    std::vector<const double*> sidechainCarriersDouble;
+
+    // Consecutive silent input samples, capped; once past the filters'
+    // memory, silent blocks skip them too
+    static constexpr int silenceSettleSamples = 256;
+    int silentSamples = silenceSettleSamples;
+};
@@ -0,0 +1,270 @@
+/*
+  DDX3216 Ring Modulator Plugin - Ring Mod Kernels Implementation
+  Baseline instruction set and the authentic table path. The AVX2 and
+  AVX-512 variants live in their own translation units.
+*/
+
+#include "RingModKernelsImpl.h"
+
+#if DDX_X86_KERNELS
+ #if defined(_MSC_VER)
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+#endif
+
+namespace
+{
+    // SHARC-style interpolated table lookup, one sample at a time
+    struct TableCarrier
+    {
+        static constexpr bool rotates = false;
+
+        template <typename Isa>
+        static typename Isa::Float eval(uint32_t phase, const float* table) noexcept
+        {
+            static_assert(Isa::width == 1, "Table carrier is scalar only");
+            return DdsOscillator::lookup<typename Isa::Scalar>(table, phase);
+        }
+    };
+
+   #if DDX_X86_KERNELS
+    // eax, ebx, ecx, edx of CPUID leaf/subleaf
+    void cpuid(unsigned leaf, unsigned subleaf, unsigned (&regs)[4]) noexcept
+    {
+       #if defined(_MSC_VER)
+        int info[4];
+        __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+        for (int i = 0; i < 4; ++i)
+            regs[i] = static_cast<unsigned>(info[i]);
+       #else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+       #endif
+    }
+
+    // Register state the OS saves on a context switch (XCR0)
+    uint64_t getEnabledRegisterState() noexcept
+    {
+       #if defined(_MSC_VER)
+        return _xgetbv(0);
+       #else
+        unsigned lo, hi;
+        __asm__ volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return (static_cast<uint64_t>(hi) << 32) | lo;
+       #endif
+    }
+   #endif
+}
+
+//==============================================================================
+bool isSimdLevelCompiled(SimdLevel level) noexcept
+{
+    return level == SimdLevel::Baseline || DDX_X86_KERNELS;
+}
+
+const char* getSimdLevelName(SimdLevel level) noexcept
+{
+    switch (level)
+    {
+    case SimdLevel::AVX2:   return "AVX2";
+    case SimdLevel::AVX512: return "AVX-512";
+    case SimdLevel::Baseline:
+    default:
+       #if DDX_SIMD_SSE2
+        return "SSE2";
+       #elif DDX_SIMD_NEON
+        return "NEON";
+       #else
+        return "Scalar";
+       #endif
+    }
+}
+
+SimdLevel getSupportedSimdLevel() noexcept
+{
+   #if DDX_X86_KERNELS
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+
+    if (regs[0] < 7)
+        return SimdLevel::Baseline;
+
+    // AVX needs the OS to save the YMM registers (OSXSAVE + XCR0)
+    cpuid(1, 0, regs);
+    const bool fma = (regs[2] & (1u << 12)) != 0;
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    const bool avx = (regs[2] & (1u << 28)) != 0;
+
+    if (! (osxsave && avx))
+        return SimdLevel::Baseline;
+
+    const auto state = getEnabledRegisterState();
+    const bool ymm = (state & 0x06) == 0x06;
+    const bool zmm = (state & 0xe6) == 0xe6;
+
+    cpuid(7, 0, regs);
+    const bool avx2 = (regs[1] & (1u << 5)) != 0;
+    const bool avx512f = (regs[1] & (1u << 16)) != 0;
+
+    if (avx512f && avx2 && fma && zmm)
+        return SimdLevel::AVX512;
+
+    if (avx2 && fma && ymm)
+        return SimdLevel::AVX2;
+   #endif
+
+    return SimdLevel::Baseline;
+}
+
+//==============================================================================
+RingModChannels getRingModChannels(int numChannels, bool monoToStereo, bool spread) noexcept
+{
+    if (spread)
+        return RingModChannels::Spread;
+
+    if (monoToStereo)
+        return RingModChannels::MonoToStereo;
+
+    return numChannels == 1 ? RingModChannels::Mono
+         : numChannels == 2 ? RingModChannels::Stereo
+                            : RingModChannels::Multichannel;
+}
+
+//==============================================================================
+template <typename SampleType>
+RingModKernel<SampleType> getRingModKernel(RingModPath path, DdsWaveform waveform, RingModChannels channels,
+                                           SimdLevel level, bool ramped, bool detect) noexcept
+{
+    using ScalarLanes = SimdScalarLanes<void, SampleType>;
+    const int shape = static_cast<int>(channels);
+
+    // SHARC emulation: the same tables, in the DSP's arithmetic on double lanes
+    if (path == RingModPath::Sharc32 || path == RingModPath::Sharc40)
+    {
+        const bool extended = path == RingModPath::Sharc40;
+
+       #if DDX_X86_KERNELS
+        if (level == SimdLevel::AVX512)
+            return getSharcKernelAVX512<SampleType>(channels, extended, ramped, detect);
+
+        if (level == SimdLevel::AVX2)
+            return getSharcKernelAVX2<SampleType>(channels, extended, ramped, detect);
+       #endif
+
+        return getSharcKernel<SimdNativeDouble, SampleType>(channels, extended, ramped, detect);
+    }
+
+    // Scalar (authentic): interpolated tables, waveform only picks the table
+    if (path == RingModPath::Scalar)
+    {
+        if (detect)
+            return ramped ? kernelRow<ScalarLanes, TableCarrier, true, true>[shape]
+                          : kernelRow<ScalarLanes, TableCarrier, false, true>[shape];
+
+        return ramped ? kernelRow<ScalarLanes, TableCarrier, true, false>[shape]
+                      : kernelRow<ScalarLanes, TableCarrier, false, false>[shape];
+    }
+
+   #if DDX_X86_KERNELS
+    if (level == SimdLevel::AVX512)
+        return getRingModKernelAVX512<SampleType>(waveform, channels, ramped, detect);
+
+    if (level == SimdLevel::AVX2)
+        return getRingModKernelAVX2<SampleType>(waveform, channels, ramped, detect);
+   #else
+    (void)level;
+   #endif
+
+    return getPolynomialKernel<SimdNativeLanes<SampleType>>(waveform, channels, ramped, detect);
+}
+
+template RingModKernel<float> getRingModKernel<float>(RingModPath, DdsWaveform, RingModChannels, SimdLevel, bool, bool) noexcept;
+template RingModKernel<double> getRingModKernel<double>(RingModPath, DdsWaveform, RingModChannels, SimdLevel, bool, bool) noexcept;
+
+//==============================================================================
+template <typename SampleType>
+CarrierBankKernel<SampleType> getCarrierBankKernel(RingModPath path, SimdLevel level, bool ramped, bool detect) noexcept
+{
+    if (path != RingModPath::SIMD)
+        return getBankKernel<SimdScalarLanes<void, SampleType>>(ramped, detect);
+
+   #if DDX_X86_KERNELS
+    if (level == SimdLevel::AVX512)
+        return getCarrierBankKernelAVX512<SampleType>(ramped, detect);
+
+    if (level == SimdLevel::AVX2)
+        return getCarrierBankKernelAVX2<SampleType>(ramped, detect);
+   #else
+    (void)level;
+   #endif
+
+    return getBankKernel<SimdNativeLanes<SampleType>>(ramped, detect);
+}
+
+template CarrierBankKernel<float> getCarrierBankKernel<float>(RingModPath, SimdLevel, bool, bool) noexcept;
+template CarrierBankKernel<double> getCarrierBankKernel<double>(RingModPath, SimdLevel, bool, bool) noexcept;
+
+//==============================================================================
+template <typename SampleType>
+VoiceBatchKernel<SampleType> getVoiceBatchKernel(SimdLevel level, bool ramped) noexcept
+{
+   #if DDX_X86_KERNELS
+    if (level == SimdLevel::AVX512)
+        return getVoiceBatchKernelAVX512<SampleType>(ramped);
+
+    if (level == SimdLevel::AVX2)
+        return getVoiceBatchKernelAVX2<SampleType>(ramped);
+   #else
+    (void)level;
+   #endif
+
+    return getBatchKernel<SimdNativeLanes<SampleType>>(ramped);
+}
+
+template VoiceBatchKernel<float> getVoiceBatchKernel<float>(SimdLevel, bool) noexcept;
+template VoiceBatchKernel<double> getVoiceBatchKernel<double>(SimdLevel, bool) noexcept;
+
+//==============================================================================
+template <typename SampleType>
+SidechainKernel<SampleType> getSidechainKernel(RingModPath path, RingModChannels channels, SimdLevel level,
+                                               bool connected, bool ramped) noexcept
+{
+    if (path != RingModPath::SIMD)
+        return getExternalKernel<SimdScalarLanes<void, SampleType>>(channels, connected, ramped);
+
+   #if DDX_X86_KERNELS
+    if (level == SimdLevel::AVX512)
+        return getSidechainKernelAVX512<SampleType>(channels, connected, ramped);
+
+    if (level == SimdLevel::AVX2)
+        return getSidechainKernelAVX2<SampleType>(channels, connected, ramped);
+   #else
+    (void)level;
+   #endif
+
+    return getExternalKernel<SimdNativeLanes<SampleType>>(channels, connected, ramped);
+}
+
+template SidechainKernel<float> getSidechainKernel<float>(RingModPath, RingModChannels, SimdLevel, bool, bool) noexcept;
+template SidechainKernel<double> getSidechainKernel<double>(RingModPath, RingModChannels, SimdLevel, bool, bool) noexcept;
+
+//==============================================================================
+template <typename SampleType>
+FirKernel<SampleType> getFirKernel(SimdLevel level) noexcept
+{
+   #if DDX_X86_KERNELS
+    if (level == SimdLevel::AVX512)
+        return getFirKernelAVX512<SampleType>();
+
+    if (level == SimdLevel::AVX2)
+        return getFirKernelAVX2<SampleType>();
+   #else
+    (void)level;
+   #endif
+
+    return firKernel<SimdNativeLanes<SampleType>>;
+}
+
+template FirKernel<float> getFirKernel<float>(SimdLevel) noexcept;
+template FirKernel<double> getFirKernel<double>(SimdLevel) noexcept;
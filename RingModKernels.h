@@ -0,0 +1,184 @@
+/*
+  DDX3216 Ring Modulator Plugin - Ring Mod Kernels
+  Carrier generation and multiply-blend, specialised at compile time on
+  sample type, processing path, waveform and channel layout, and built once
+  per vector instruction set. processBlock picks one kernel from the
+  dispatch table per block so the hot loops carry no branches on any of
+  these.
+*/
+
+#pragma once
+#include <cstdint>
+#include "DdsOscillator.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #define DDX_X86_KERNELS 1
+#else
+ #define DDX_X86_KERNELS 0
+#endif
+
+//==============================================================================
+// Everything a kernel needs for one block (channels are processed in place)
+//==============================================================================
+template <typename SampleType>
+struct RingModBlock
+{
+    SampleType* const* channels = nullptr;
+    int numChannels = 0;
+    int startSample = 0;
+    int numSamples = 0;
+    SampleType blend = 0;
+
+    // Per-sample parameter slopes, only read by the ramped kernels
+    SampleType blendStep = 0;
+    int32_t phaseIncStep = 0;
+
+    // Table for the authentic path, scratch for the N-channel kernels
+    // (at least 48 samples; the spread sine kernel splits it three ways)
+    const float* table = nullptr;
+    SampleType* modulator = nullptr;
+    int modulatorSize = 0;
+
+    // Per-channel carrier phase offsets, only read by the Spread kernels
+    const uint32_t* phaseOffsets = nullptr;
+
+    // Detect kernels raise *peak to the largest |input| they multiplied
+    SampleType* peak = nullptr;
+};
+
+// Scalar: the authentic tables in host arithmetic. SIMD: polynomial
+// shapes. Sharc32/Sharc40: the tables in emulated ADSP-21160 arithmetic,
+// 32-bit float or 40-bit extended precision (main carrier only; the bank
+// and the sidechain run as Scalar).
+enum class RingModPath { Scalar, SIMD, Sharc32, Sharc40 };
+
+// How the carrier is shared between the channels of a block
+enum class RingModChannels
+{
+    Mono,           // one channel
+    Stereo,         // two channels, one carrier
+    Multichannel,   // any number of channels, one carrier
+    MonoToStereo,   // channel 0 in, the result written to channels 0 and 1
+    Spread          // any number of channels, carrier offset by phaseOffsets[ch]
+};
+
+RingModChannels getRingModChannels(int numChannels, bool monoToStereo, bool spread) noexcept;
+
+// Vector instruction set used by the SIMD path. Baseline is SSE2 on x86,
+// NEON on ARM and plain scalar code anywhere else.
+enum class SimdLevel { Baseline, AVX2, AVX512 };
+
+// Returns the carrier phase after the block
+template <typename SampleType>
+using RingModKernel = uint32_t (*)(const RingModBlock<SampleType>&, uint32_t phase, uint32_t phaseInc) noexcept;
+
+// Mono and stereo kernels generate the carrier in registers and apply it
+// directly; other layouts render it once into block.modulator and share it.
+// Spread sine kernels render the base carrier's sine and cosine once and
+// rotate them per channel; the other spread kernels run each channel at
+// its own phase. Ramped kernels follow blendStep/phaseIncStep, the others
+// assume constant parameters. Detect kernels also track the input peak for
+// the envelope follower, in the same pass as the multiply. Sharc kernels
+// treat every layout but MonoToStereo and Spread channel by channel on one
+// carrier, and are bit-identical at every level. Levels that were not
+// compiled in fall back to Baseline. Instantiated for float and double.
+template <typename SampleType>
+RingModKernel<SampleType> getRingModKernel(RingModPath path, DdsWaveform waveform, RingModChannels channels,
+                                           SimdLevel level, bool ramped, bool detect) noexcept;
+
+//==============================================================================
+// Multi-carrier bank, structure-of-arrays. Carriers are grouped by shape:
+// [0, waveformEnd[0]) are sines, then triangles up to waveformEnd[1], then
+// squares up to waveformEnd[2] == numCarriers. The kernel moves phase and
+// phaseInc on in place.
+//==============================================================================
+struct CarrierBank
+{
+    static constexpr int maxCarriers = 16;
+
+    int numCarriers = 0;
+    int waveformEnd[3] = {};
+
+    alignas(64) uint32_t phase[maxCarriers] = {};
+    alignas(64) uint32_t phaseInc[maxCarriers] = {};
+    alignas(64) int32_t phaseIncStep[maxCarriers] = {};   // ramped kernels only
+    alignas(64) float level[maxCarriers] = {};
+};
+
+template <typename SampleType>
+using CarrierBankKernel = void (*)(const RingModBlock<SampleType>&, CarrierBank&) noexcept;
+
+// Sums the bank into block.modulator (one register of samples at a time,
+// every carrier per register) and applies it to every channel. Uses the
+// polynomial shapes on both paths; Scalar runs them one lane at a time.
+template <typename SampleType>
+CarrierBankKernel<SampleType> getCarrierBankKernel(RingModPath path, SimdLevel level, bool ramped, bool detect) noexcept;
+
+//==============================================================================
+// Voice batch: many independent single-carrier ring mods, structure-of-
+// arrays, slot s driving channels [s * channelsPerVoice, (s + 1) *
+// channelsPerVoice). Slots are grouped by shape like the carrier bank, so
+// a register of voices always shares one. The kernel reads the arrays and
+// leaves moving the phases on to the caller.
+//==============================================================================
+template <typename SampleType>
+struct RingModVoiceBlock
+{
+    SampleType* const* channels = nullptr;
+    int channelsPerVoice = 1;
+    int numVoices = 0;
+    int numSamples = 0;
+    int waveformEnd[3] = {};
+
+    const uint32_t* phase = nullptr;
+    const uint32_t* phaseInc = nullptr;
+    const int32_t* phaseIncStep = nullptr;      // ramped kernels only
+    const SampleType* blend = nullptr;
+    const SampleType* blendStep = nullptr;      // ramped kernels only
+
+    // Gain scratch for the samples past the last whole tile: 16 x 16
+    SampleType* gains = nullptr;
+};
+
+template <typename SampleType>
+using VoiceBatchKernel = void (*)(const RingModVoiceBlock<SampleType>&) noexcept;
+
+// Renders a register of voices' gains at once (polynomial shapes, as the
+// SIMD path), a register's width of samples at a time, and transposes
+// the tile so each voice's channels are multiplied a register at a time.
+// Arrays are read with unaligned loads.
+template <typename SampleType>
+VoiceBatchKernel<SampleType> getVoiceBatchKernel(SimdLevel level, bool ramped) noexcept;
+
+//==============================================================================
+// External carrier (sidechain): out = in * ((1 - blend) + blend * carrier),
+// the carrier read sample for sample from carriers[ch], offset by
+// block.startSample like the channels. A mono sidechain on a wider bus
+// passes the same pointer for every channel; with no sidechain connected
+// (Connected = false) carriers is ignored and only the dry part is left.
+// MonoToStereo reads channel 0 and writes channels 0 and 1, loading the
+// input and both carriers before either store, so a sidechain channel that
+// shares storage with output channel 1 is read before it is overwritten.
+// Every other layout runs channel by channel.
+//==============================================================================
+template <typename SampleType>
+using SidechainKernel = void (*)(const RingModBlock<SampleType>&, const SampleType* const* carriers) noexcept;
+
+template <typename SampleType>
+SidechainKernel<SampleType> getSidechainKernel(RingModPath path, RingModChannels channels, SimdLevel level,
+                                               bool connected, bool ramped) noexcept;
+
+// FIR used by the oversampling filters, out[k] = sum_i coeffs[i] * input[k + i]
+// for k in [0, numOutputs). input must hold numOutputs + numTaps - 1 samples.
+template <typename SampleType>
+using FirKernel = void (*)(const SampleType* input, const SampleType* coeffs, int numTaps,
+                           SampleType* out, int numOutputs) noexcept;
+
+template <typename SampleType>
+FirKernel<SampleType> getFirKernel(SimdLevel level) noexcept;
+
+bool isSimdLevelCompiled(SimdLevel level) noexcept;
+const char* getSimdLevelName(SimdLevel level) noexcept;
+
+// Widest level this build has and this CPU (and OS) can run
+SimdLevel getSupportedSimdLevel() noexcept;
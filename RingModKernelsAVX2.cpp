@@ -0,0 +1,223 @@
+/*
+  DDX3216 Ring Modulator Plugin - AVX2 Ring Mod Kernels
+  Built for AVX2 + FMA whatever the project's global architecture flags.
+  Only called after the processor has checked the CPU supports it.
+*/
+
+#include "RingModKernels.h"
+
+#if DDX_X86_KERNELS
+
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include <immintrin.h>
+
+#if defined(__clang__)
+ #pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target("avx2,fma")
+#endif
+
+#include "RingModKernelsImpl.h"
+
+namespace
+{
+    //==============================================================================
+    struct SimdAVX2
+    {
+        using Scalar = float;
+        using Float = __m256;
+        using UInt = __m256i;
+        static constexpr int width = 8;
+
+        static Float load(const float* p) noexcept            { return _mm256_loadu_ps(p); }
+        static UInt loadU(const uint32_t* p) noexcept         { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        static void store(float* p, Float v) noexcept         { _mm256_storeu_ps(p, v); }
+        static Float set(float v) noexcept                    { return _mm256_set1_ps(v); }
+        static UInt setU(uint32_t v) noexcept                 { return _mm256_set1_epi32(static_cast<int>(v)); }
+        static UInt rampU(uint32_t start, uint32_t step) noexcept
+        {
+            const auto lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            return _mm256_add_epi32(setU(start), _mm256_mullo_epi32(setU(step), lanes));
+        }
+
+        static Float add(Float a, Float b) noexcept           { return _mm256_add_ps(a, b); }
+        static Float sub(Float a, Float b) noexcept           { return _mm256_sub_ps(a, b); }
+        static Float mul(Float a, Float b) noexcept           { return _mm256_mul_ps(a, b); }
+        static Float mulAdd(Float a, Float b, Float c) noexcept { return _mm256_fmadd_ps(a, b, c); }
+        static UInt addU(UInt a, UInt b) noexcept             { return _mm256_add_epi32(a, b); }
+
+        static Float fromSigned(UInt v) noexcept              { return _mm256_cvtepi32_ps(v); }
+        static Float abs(Float v) noexcept                    { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+        static Float max(Float a, Float b) noexcept           { return _mm256_max_ps(a, b); }
+        static Float copySign(Float mag, Float sign) noexcept
+        {
+            const auto mask = _mm256_set1_ps(-0.0f);
+            return _mm256_or_ps(_mm256_andnot_ps(mask, mag), _mm256_and_ps(mask, sign));
+        }
+
+        // Voice batches: rows of a width x width tile become its columns
+        static void transpose(Float* rows) noexcept
+        {
+            Float pairs[8], quads[8];
+
+            for (int k = 0; k < 8; k += 2)
+            {
+                pairs[k] = _mm256_unpacklo_ps(rows[k], rows[k + 1]);
+                pairs[k + 1] = _mm256_unpackhi_ps(rows[k], rows[k + 1]);
+            }
+
+            for (int k = 0; k < 8; k += 4)
+            {
+                quads[k] = _mm256_shuffle_ps(pairs[k], pairs[k + 2], 0x44);
+                quads[k + 1] = _mm256_shuffle_ps(pairs[k], pairs[k + 2], 0xee);
+                quads[k + 2] = _mm256_shuffle_ps(pairs[k + 1], pairs[k + 3], 0x44);
+                quads[k + 3] = _mm256_shuffle_ps(pairs[k + 1], pairs[k + 3], 0xee);
+            }
+
+            for (int k = 0; k < 4; ++k)
+            {
+                rows[k] = _mm256_permute2f128_ps(quads[k], quads[k + 4], 0x20);
+                rows[k + 4] = _mm256_permute2f128_ps(quads[k], quads[k + 4], 0x31);
+            }
+        }
+    };
+
+    // Four doubles per register, phases in a 128-bit register of four lanes
+    struct SimdAVX2Double
+    {
+        using Scalar = double;
+        using Float = __m256d;
+        using UInt = __m128i;
+        static constexpr int width = 4;
+
+        static Float load(const double* p) noexcept           { return _mm256_loadu_pd(p); }
+        static UInt loadU(const uint32_t* p) noexcept         { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        static void store(double* p, Float v) noexcept        { _mm256_storeu_pd(p, v); }
+        static Float set(double v) noexcept                   { return _mm256_set1_pd(v); }
+        static UInt setU(uint32_t v) noexcept                 { return _mm_set1_epi32(static_cast<int>(v)); }
+        static UInt rampU(uint32_t start, uint32_t step) noexcept
+        {
+            const auto lanes = _mm_setr_epi32(0, 1, 2, 3);
+            return _mm_add_epi32(setU(start), _mm_mullo_epi32(setU(step), lanes));
+        }
+
+        static Float add(Float a, Float b) noexcept           { return _mm256_add_pd(a, b); }
+        static Float sub(Float a, Float b) noexcept           { return _mm256_sub_pd(a, b); }
+        static Float mul(Float a, Float b) noexcept           { return _mm256_mul_pd(a, b); }
+        static Float mulAdd(Float a, Float b, Float c) noexcept { return _mm256_fmadd_pd(a, b, c); }
+        static UInt addU(UInt a, UInt b) noexcept             { return _mm_add_epi32(a, b); }
+
+        static Float fromSigned(UInt v) noexcept              { return _mm256_cvtepi32_pd(v); }
+        static Float abs(Float v) noexcept                    { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v); }
+        static Float max(Float a, Float b) noexcept           { return _mm256_max_pd(a, b); }
+        static Float copySign(Float mag, Float sign) noexcept
+        {
+            const auto mask = _mm256_set1_pd(-0.0);
+            return _mm256_or_pd(_mm256_andnot_pd(mask, mag), _mm256_and_pd(mask, sign));
+        }
+
+        // Voice batches: rows of a width x width tile become its columns
+        static void transpose(Float* rows) noexcept
+        {
+            const auto low01 = _mm256_unpacklo_pd(rows[0], rows[1]);
+            const auto high01 = _mm256_unpackhi_pd(rows[0], rows[1]);
+            const auto low23 = _mm256_unpacklo_pd(rows[2], rows[3]);
+            const auto high23 = _mm256_unpackhi_pd(rows[2], rows[3]);
+            rows[0] = _mm256_permute2f128_pd(low01, low23, 0x20);
+            rows[1] = _mm256_permute2f128_pd(high01, high23, 0x20);
+            rows[2] = _mm256_permute2f128_pd(low01, low23, 0x31);
+            rows[3] = _mm256_permute2f128_pd(high01, high23, 0x31);
+        }
+
+        // Emulation kernels: float memory, table gathers and the raw bits
+        using Bits = __m256i;
+
+        static Float loadFloat(const float* p) noexcept       { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+        static void storeFloat(float* p, Float v) noexcept    { _mm_storeu_ps(p, _mm256_cvtpd_ps(v)); }
+        static Float gather(const float* table, UInt index) noexcept { return _mm256_cvtps_pd(_mm_i32gather_ps(table, index, 4)); }
+        template <int N>
+        static UInt shiftRightU(UInt v) noexcept              { return _mm_srli_epi32(v, N); }
+        static UInt andU(UInt a, UInt b) noexcept             { return _mm_and_si128(a, b); }
+
+        static Bits asBits(Float v) noexcept                  { return _mm256_castpd_si256(v); }
+        static Float fromBits(Bits b) noexcept                { return _mm256_castsi256_pd(b); }
+        static Bits setB(uint64_t v) noexcept                 { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+        static Bits addB(Bits a, Bits b) noexcept             { return _mm256_add_epi64(a, b); }
+        static Bits subB(Bits a, Bits b) noexcept             { return _mm256_sub_epi64(a, b); }
+        static Bits andB(Bits a, Bits b) noexcept             { return _mm256_and_si256(a, b); }
+        static Bits andNotB(Bits a, Bits b) noexcept          { return _mm256_andnot_si256(a, b); }
+        template <int N>
+        static Bits shiftRightB(Bits v) noexcept              { return _mm256_srli_epi64(v, N); }
+        static Bits lessMask(Float a, Float b) noexcept       { return _mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+    };
+}
+
+template <typename SampleType>
+RingModKernel<SampleType> getRingModKernelAVX2(DdsWaveform waveform, RingModChannels channels, bool ramped, bool detect) noexcept
+{
+    using Isa = std::conditional_t<std::is_same_v<SampleType, double>, SimdAVX2Double, SimdAVX2>;
+    return getPolynomialKernel<Isa>(waveform, channels, ramped, detect);
+}
+
+template RingModKernel<float> getRingModKernelAVX2<float>(DdsWaveform, RingModChannels, bool, bool) noexcept;
+template RingModKernel<double> getRingModKernelAVX2<double>(DdsWaveform, RingModChannels, bool, bool) noexcept;
+
+template <typename SampleType>
+CarrierBankKernel<SampleType> getCarrierBankKernelAVX2(bool ramped, bool detect) noexcept
+{
+    using Isa = std::conditional_t<std::is_same_v<SampleType, double>, SimdAVX2Double, SimdAVX2>;
+    return getBankKernel<Isa>(ramped, detect);
+}
+
+template CarrierBankKernel<float> getCarrierBankKernelAVX2<float>(bool, bool) noexcept;
+template CarrierBankKernel<double> getCarrierBankKernelAVX2<double>(bool, bool) noexcept;
+
+template <typename SampleType>
+VoiceBatchKernel<SampleType> getVoiceBatchKernelAVX2(bool ramped) noexcept
+{
+    using Isa = std::conditional_t<std::is_same_v<SampleType, double>, SimdAVX2Double, SimdAVX2>;
+    return getBatchKernel<Isa>(ramped);
+}
+
+template VoiceBatchKernel<float> getVoiceBatchKernelAVX2<float>(bool) noexcept;
+template VoiceBatchKernel<double> getVoiceBatchKernelAVX2<double>(bool) noexcept;
+
+template <typename SampleType>
+SidechainKernel<SampleType> getSidechainKernelAVX2(RingModChannels channels, bool connected, bool ramped) noexcept
+{
+    using Isa = std::conditional_t<std::is_same_v<SampleType, double>, SimdAVX2Double, SimdAVX2>;
+    return getExternalKernel<Isa>(channels, connected, ramped);
+}
+
+template SidechainKernel<float> getSidechainKernelAVX2<float>(RingModChannels, bool, bool) noexcept;
+template SidechainKernel<double> getSidechainKernelAVX2<double>(RingModChannels, bool, bool) noexcept;
+
+template <typename SampleType>
+FirKernel<SampleType> getFirKernelAVX2() noexcept
+{
+    using Isa = std::conditional_t<std::is_same_v<SampleType, double>, SimdAVX2Double, SimdAVX2>;
+    return firKernel<Isa>;
+}
+
+template FirKernel<float> getFirKernelAVX2<float>() noexcept;
+template FirKernel<double> getFirKernelAVX2<double>() noexcept;
+
+template <typename SampleType>
+RingModKernel<SampleType> getSharcKernelAVX2(RingModChannels channels, bool extended, bool ramped, bool detect) noexcept
+{
+    return getSharcKernel<SimdAVX2Double, SampleType>(channels, extended, ramped, detect);
+}
+
+template RingModKernel<float> getSharcKernelAVX2<float>(RingModChannels, bool, bool, bool) noexcept;
+template RingModKernel<double> getSharcKernelAVX2<double>(RingModChannels, bool, bool, bool) noexcept;
+
+#if defined(__clang__)
+ #pragma clang attribute pop
+#elif defined(__GNUC__)
+ #pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,254 @@
+/*
+  DDX3216 Ring Modulator Plugin - AVX-512 Ring Mod Kernels
+  Built for AVX-512F whatever the project's global architecture flags.
+  Only called after the processor has checked the CPU supports it.
+*/
+
+#include "RingModKernels.h"
+
+#if DDX_X86_KERNELS
+
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include <immintrin.h>
+
+#if defined(__clang__)
+ #pragma clang attribute push (__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target("avx512f,avx2,fma")
+ // GCC's own _mm512_undefined_*() trip these warnings when inlined
+ #pragma GCC diagnostic push
+ #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+ #pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+#include "RingModKernelsImpl.h"
+
+namespace
+{
+    //==============================================================================
+    // AVX-512F has no float bitwise ops (those are AVX-512DQ), so the sign
+    // handling goes through the integer side
+    //==============================================================================
+    struct SimdAVX512
+    {
+        using Scalar = float;
+        using Float = __m512;
+        using UInt = __m512i;
+        static constexpr int width = 16;
+
+        static Float load(const float* p) noexcept            { return _mm512_loadu_ps(p); }
+        static UInt loadU(const uint32_t* p) noexcept         { return _mm512_loadu_si512(p); }
+        static void store(float* p, Float v) noexcept         { _mm512_storeu_ps(p, v); }
+        static Float set(float v) noexcept                    { return _mm512_set1_ps(v); }
+        static UInt setU(uint32_t v) noexcept                 { return _mm512_set1_epi32(static_cast<int>(v)); }
+        static UInt rampU(uint32_t start, uint32_t step) noexcept
+        {
+            const auto lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            return _mm512_add_epi32(setU(start), _mm512_mullo_epi32(setU(step), lanes));
+        }
+
+        static Float add(Float a, Float b) noexcept           { return _mm512_add_ps(a, b); }
+        static Float sub(Float a, Float b) noexcept           { return _mm512_sub_ps(a, b); }
+        static Float mul(Float a, Float b) noexcept           { return _mm512_mul_ps(a, b); }
+        static Float mulAdd(Float a, Float b, Float c) noexcept { return _mm512_fmadd_ps(a, b, c); }
+        static UInt addU(UInt a, UInt b) noexcept             { return _mm512_add_epi32(a, b); }
+
+        static Float fromSigned(UInt v) noexcept              { return _mm512_cvtepi32_ps(v); }
+        static Float abs(Float v) noexcept                    { return _mm512_abs_ps(v); }
+        static Float max(Float a, Float b) noexcept           { return _mm512_max_ps(a, b); }
+        static Float copySign(Float mag, Float sign) noexcept
+        {
+            const auto mask = _mm512_set1_epi32(static_cast<int>(0x80000000u));
+            return _mm512_castsi512_ps(_mm512_or_si512(_mm512_andnot_si512(mask, _mm512_castps_si512(mag)),
+                                                       _mm512_and_si512(mask, _mm512_castps_si512(sign))));
+        }
+
+        // Voice batches: rows of a width x width tile become its columns.
+        // Pairs and quads as in AVX2, then 128-bit blocks across registers.
+        static void transpose(Float* rows) noexcept
+        {
+            Float pairs[16], quads[16];
+
+            for (int k = 0; k < 16; k += 2)
+            {
+                pairs[k] = _mm512_unpacklo_ps(rows[k], rows[k + 1]);
+                pairs[k + 1] = _mm512_unpackhi_ps(rows[k], rows[k + 1]);
+            }
+
+            for (int k = 0; k < 16; k += 4)
+            {
+                quads[k] = _mm512_shuffle_ps(pairs[k], pairs[k + 2], 0x44);
+                quads[k + 1] = _mm512_shuffle_ps(pairs[k], pairs[k + 2], 0xee);
+                quads[k + 2] = _mm512_shuffle_ps(pairs[k + 1], pairs[k + 3], 0x44);
+                quads[k + 3] = _mm512_shuffle_ps(pairs[k + 1], pairs[k + 3], 0xee);
+            }
+
+            for (int k = 0; k < 4; ++k)
+            {
+                const auto evenLow = _mm512_shuffle_f32x4(quads[k], quads[k + 4], 0x88);
+                const auto oddLow = _mm512_shuffle_f32x4(quads[k], quads[k + 4], 0xdd);
+                const auto evenHigh = _mm512_shuffle_f32x4(quads[k + 8], quads[k + 12], 0x88);
+                const auto oddHigh = _mm512_shuffle_f32x4(quads[k + 8], quads[k + 12], 0xdd);
+                rows[k] = _mm512_shuffle_f32x4(evenLow, evenHigh, 0x88);
+                rows[k + 4] = _mm512_shuffle_f32x4(oddLow, oddHigh, 0x88);
+                rows[k + 8] = _mm512_shuffle_f32x4(evenLow, evenHigh, 0xdd);
+                rows[k + 12] = _mm512_shuffle_f32x4(oddLow, oddHigh, 0xdd);
+            }
+        }
+    };
+
+    // Eight doubles per register, phases in a 256-bit register of eight lanes
+    struct SimdAVX512Double
+    {
+        using Scalar = double;
+        using Float = __m512d;
+        using UInt = __m256i;
+        static constexpr int width = 8;
+
+        static Float load(const double* p) noexcept           { return _mm512_loadu_pd(p); }
+        static UInt loadU(const uint32_t* p) noexcept         { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        static void store(double* p, Float v) noexcept        { _mm512_storeu_pd(p, v); }
+        static Float set(double v) noexcept                   { return _mm512_set1_pd(v); }
+        static UInt setU(uint32_t v) noexcept                 { return _mm256_set1_epi32(static_cast<int>(v)); }
+        static UInt rampU(uint32_t start, uint32_t step) noexcept
+        {
+            const auto lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            return _mm256_add_epi32(setU(start), _mm256_mullo_epi32(setU(step), lanes));
+        }
+
+        static Float add(Float a, Float b) noexcept           { return _mm512_add_pd(a, b); }
+        static Float sub(Float a, Float b) noexcept           { return _mm512_sub_pd(a, b); }
+        static Float mul(Float a, Float b) noexcept           { return _mm512_mul_pd(a, b); }
+        static Float mulAdd(Float a, Float b, Float c) noexcept { return _mm512_fmadd_pd(a, b, c); }
+        static UInt addU(UInt a, UInt b) noexcept             { return _mm256_add_epi32(a, b); }
+
+        static Float fromSigned(UInt v) noexcept              { return _mm512_cvtepi32_pd(v); }
+        static Float abs(Float v) noexcept                    { return _mm512_abs_pd(v); }
+        static Float max(Float a, Float b) noexcept           { return _mm512_max_pd(a, b); }
+        static Float copySign(Float mag, Float sign) noexcept
+        {
+            const auto mask = _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ull));
+            return _mm512_castsi512_pd(_mm512_or_si512(_mm512_andnot_si512(mask, _mm512_castpd_si512(mag)),
+                                                       _mm512_and_si512(mask, _mm512_castpd_si512(sign))));
+        }
+
+        // Voice batches: rows of a width x width tile become its columns
+        static void transpose(Float* rows) noexcept
+        {
+            Float pairs[8];
+
+            for (int k = 0; k < 8; k += 2)
+            {
+                pairs[k] = _mm512_unpacklo_pd(rows[k], rows[k + 1]);
+                pairs[k + 1] = _mm512_unpackhi_pd(rows[k], rows[k + 1]);
+            }
+
+            for (int k = 0; k < 2; ++k)
+            {
+                const auto evenLow = _mm512_shuffle_f64x2(pairs[k], pairs[k + 2], 0x88);
+                const auto oddLow = _mm512_shuffle_f64x2(pairs[k], pairs[k + 2], 0xdd);
+                const auto evenHigh = _mm512_shuffle_f64x2(pairs[k + 4], pairs[k + 6], 0x88);
+                const auto oddHigh = _mm512_shuffle_f64x2(pairs[k + 4], pairs[k + 6], 0xdd);
+                rows[k] = _mm512_shuffle_f64x2(evenLow, evenHigh, 0x88);
+                rows[k + 2] = _mm512_shuffle_f64x2(oddLow, oddHigh, 0x88);
+                rows[k + 4] = _mm512_shuffle_f64x2(evenLow, evenHigh, 0xdd);
+                rows[k + 6] = _mm512_shuffle_f64x2(oddLow, oddHigh, 0xdd);
+            }
+        }
+
+        // Emulation kernels: float memory, table gathers and the raw bits
+        using Bits = __m512i;
+
+        static Float loadFloat(const float* p) noexcept       { return _mm512_cvtps_pd(_mm256_loadu_ps(p)); }
+        static void storeFloat(float* p, Float v) noexcept    { _mm256_storeu_ps(p, _mm512_cvtpd_ps(v)); }
+        static Float gather(const float* table, UInt index) noexcept { return _mm512_cvtps_pd(_mm256_i32gather_ps(table, index, 4)); }
+        template <int N>
+        static UInt shiftRightU(UInt v) noexcept              { return _mm256_srli_epi32(v, N); }
+        static UInt andU(UInt a, UInt b) noexcept             { return _mm256_and_si256(a, b); }
+
+        static Bits asBits(Float v) noexcept                  { return _mm512_castpd_si512(v); }
+        static Float fromBits(Bits b) noexcept                { return _mm512_castsi512_pd(b); }
+        static Bits setB(uint64_t v) noexcept                 { return _mm512_set1_epi64(static_cast<long long>(v)); }
+        static Bits addB(Bits a, Bits b) noexcept             { return _mm512_add_epi64(a, b); }
+        static Bits subB(Bits a, Bits b) noexcept             { return _mm512_sub_epi64(a, b); }
+        static Bits andB(Bits a, Bits b) noexcept             { return _mm512_and_si512(a, b); }
+        static Bits andNotB(Bits a, Bits b) noexcept          { return _mm512_andnot_si512(a, b); }
+        template <int N>
+        static Bits shiftRightB(Bits v) noexcept              { return _mm512_srli_epi64(v, N); }
+        static Bits lessMask(Float a, Float b) noexcept
+        {
+            return _mm512_maskz_mov_epi64(_mm512_cmp_pd_mask(a, b, _CMP_LT_OQ), _mm512_set1_epi64(-1));
+        }
+    };
+}
+
+template <typename SampleType>
+RingModKernel<SampleType> getRingModKernelAVX512(DdsWaveform waveform, RingModChannels channels, bool ramped, bool detect) noexcept
+{
+    using Isa = std::conditional_t<std::is_same_v<SampleType, double>, SimdAVX512Double, SimdAVX512>;
+    return getPolynomialKernel<Isa>(waveform, channels, ramped, detect);
+}
+
+template RingModKernel<float> getRingModKernelAVX512<float>(DdsWaveform, RingModChannels, bool, bool) noexcept;
+template RingModKernel<double> getRingModKernelAVX512<double>(DdsWaveform, RingModChannels, bool, bool) noexcept;
+
+template <typename SampleType>
+CarrierBankKernel<SampleType> getCarrierBankKernelAVX512(bool ramped, bool detect) noexcept
+{
+    using Isa = std::conditional_t<std::is_same_v<SampleType, double>, SimdAVX512Double, SimdAVX512>;
+    return getBankKernel<Isa>(ramped, detect);
+}
+
+template CarrierBankKernel<float> getCarrierBankKernelAVX512<float>(bool, bool) noexcept;
+template CarrierBankKernel<double> getCarrierBankKernelAVX512<double>(bool, bool) noexcept;
+
+template <typename SampleType>
+VoiceBatchKernel<SampleType> getVoiceBatchKernelAVX512(bool ramped) noexcept
+{
+    using Isa = std::conditional_t<std::is_same_v<SampleType, double>, SimdAVX512Double, SimdAVX512>;
+    return getBatchKernel<Isa>(ramped);
+}
+
+template VoiceBatchKernel<float> getVoiceBatchKernelAVX512<float>(bool) noexcept;
+template VoiceBatchKernel<double> getVoiceBatchKernelAVX512<double>(bool) noexcept;
+
+template <typename SampleType>
+SidechainKernel<SampleType> getSidechainKernelAVX512(RingModChannels channels, bool connected, bool ramped) noexcept
+{
+    using Isa = std::conditional_t<std::is_same_v<SampleType, double>, SimdAVX512Double, SimdAVX512>;
+    return getExternalKernel<Isa>(channels, connected, ramped);
+}
+
+template SidechainKernel<float> getSidechainKernelAVX512<float>(RingModChannels, bool, bool) noexcept;
+template SidechainKernel<double> getSidechainKernelAVX512<double>(RingModChannels, bool, bool) noexcept;
+
+template <typename SampleType>
+FirKernel<SampleType> getFirKernelAVX512() noexcept
+{
+    using Isa = std::conditional_t<std::is_same_v<SampleType, double>, SimdAVX512Double, SimdAVX512>;
+    return firKernel<Isa>;
+}
+
+template FirKernel<float> getFirKernelAVX512<float>() noexcept;
+template FirKernel<double> getFirKernelAVX512<double>() noexcept;
+
+template <typename SampleType>
+RingModKernel<SampleType> getSharcKernelAVX512(RingModChannels channels, bool extended, bool ramped, bool detect) noexcept
+{
+    return getSharcKernel<SimdAVX512Double, SampleType>(channels, extended, ramped, detect);
+}
+
+template RingModKernel<float> getSharcKernelAVX512<float>(RingModChannels, bool, bool, bool) noexcept;
+template RingModKernel<double> getSharcKernelAVX512<double>(RingModChannels, bool, bool, bool) noexcept;
+
+#if defined(__clang__)
+ #pragma clang attribute pop
+#elif defined(__GNUC__)
+ #pragma GCC diagnostic pop
+ #pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,1115 @@
+/*
+  DDX3216 Ring Modulator Plugin - Ring Mod Kernel Templates
+  Shared by every instruction-set translation unit (RingModKernels*.cpp).
+  Everything here is templated on the vector type or has internal linkage,
+  so each unit emits its own copies compiled for its own target - no inline
+  code built for AVX can end up being called on a machine that only has
+  SSE2.
+*/
+
+#pragma once
+#include "RingModKernels.h"
+#include "RingModSimd.h"
+
+// Not templated on the instruction set, so internal to each unit: shared,
+// the linker would pick one unit's copy (maybe built for AVX) for all
+namespace
+{
+    //==============================================================================
+    // Carrier source: evaluate one register's worth of carrier from its phases
+    //==============================================================================
+    template <DdsWaveform Shape>
+    struct PolynomialCarrier
+    {
+        // Offset copies can be made by rotating sine and cosine (spread kernels)
+        static constexpr bool rotates = Shape == DdsWaveform::Sine;
+
+        template <typename Isa>
+        static typename Isa::Float eval(typename Isa::UInt phase, const float*) noexcept
+        {
+            if constexpr (Shape == DdsWaveform::Sine)
+                return SimdWaveforms<Isa>::sine(phase);
+            else if constexpr (Shape == DdsWaveform::Triangle)
+                return SimdWaveforms<Isa>::triangle(phase);
+            else
+                return SimdWaveforms<Isa>::square(phase);
+        }
+    };
+
+    //==============================================================================
+    // Running parameters at the first sample a pass has not processed yet
+    //==============================================================================
+    template <typename SampleType>
+    struct KernelState
+    {
+        uint32_t phase;
+        uint32_t phaseInc;
+        SampleType blend;
+
+        // Closed form of n steps of the (possibly ramped) recurrences, mod 2^32
+        void advance(int n, int32_t phaseIncStep, SampleType blendStep) noexcept
+        {
+            const auto steps = static_cast<uint64_t>(n);
+            const auto triangular = static_cast<uint32_t>(steps * (steps - 1) / 2);
+            phase += static_cast<uint32_t>(n) * phaseInc + static_cast<uint32_t>(phaseIncStep) * triangular;
+            phaseInc += static_cast<uint32_t>(n) * static_cast<uint32_t>(phaseIncStep);
+            blend += static_cast<SampleType>(n) * blendStep;
+        }
+    };
+}
+
+//==============================================================================
+// Phases for one register of lanes. With a constant increment the phase
+// moves with a single add; a linear increment ramp keeps a second
+// difference (step grows by width^2 * incStep) so it still costs only adds.
+//==============================================================================
+template <typename Isa, bool Ramped>
+struct PhaseLanes
+{
+    using UInt = typename Isa::UInt;
+    static constexpr int width = Isa::width;
+
+    PhaseLanes() noexcept = default;
+
+    PhaseLanes(uint32_t startPhase, uint32_t phaseInc, int32_t phaseIncStep) noexcept
+    {
+        if constexpr (Ramped)
+        {
+            alignas(64) uint32_t phases[width];
+            alignas(64) uint32_t steps[width];
+            const auto incStep = static_cast<uint32_t>(phaseIncStep);
+
+            for (int k = 0; k < width; ++k)
+            {
+                const auto lane = static_cast<uint32_t>(k);
+                phases[k] = startPhase + lane * phaseInc + incStep * (lane * (lane - 1u) / 2u);
+                steps[k] = static_cast<uint32_t>(width) * (phaseInc + lane * incStep);
+            }
+
+            phase = Isa::loadU(phases);
+            step = Isa::loadU(steps);
+
+            constexpr auto w = static_cast<uint32_t>(width);
+            curve = Isa::setU(incStep * (w * (w - 1u) / 2u));
+            stepDelta = Isa::setU(incStep * w * w);
+        }
+        else
+        {
+            (void)phaseIncStep;
+            phase = Isa::rampU(startPhase, phaseInc);
+            step = Isa::setU(phaseInc * static_cast<uint32_t>(width));
+        }
+    }
+
+    void advance() noexcept
+    {
+        if constexpr (Ramped)
+        {
+            phase = Isa::addU(phase, Isa::addU(step, curve));
+            step = Isa::addU(step, stepDelta);
+        }
+        else
+        {
+            phase = Isa::addU(phase, step);
+        }
+    }
+
+    UInt phase {}, step {}, curve {}, stepDelta {};
+};
+
+//==============================================================================
+// Phase and blend for one register of lanes
+//==============================================================================
+template <typename Isa, bool Ramped>
+struct LaneParameters : PhaseLanes<Isa, Ramped>
+{
+    using Scalar = typename Isa::Scalar;
+    using Float = typename Isa::Float;
+    static constexpr int width = Isa::width;
+
+    LaneParameters(const KernelState<Scalar>& state, const RingModBlock<Scalar>& block) noexcept
+        : PhaseLanes<Isa, Ramped>(state.phase, state.phaseInc, block.phaseIncStep)
+    {
+        if constexpr (Ramped)
+        {
+            alignas(64) Scalar blends[width];
+
+            for (int k = 0; k < width; ++k)
+                blends[k] = state.blend + static_cast<Scalar>(k) * block.blendStep;
+
+            blend = Isa::load(blends);
+            blendDelta = Isa::set(block.blendStep * static_cast<Scalar>(width));
+        }
+        else
+        {
+            blend = Isa::set(state.blend);
+            oneMinusBlend = Isa::set(Scalar(1) - state.blend);
+        }
+    }
+
+    // Output gain: (1 - blend) + blend * carrier
+    Float gain(Float carrier) const noexcept
+    {
+        if constexpr (Ramped)
+            return Isa::mulAdd(blend, carrier, Isa::sub(Isa::set(Scalar(1)), blend));
+        else
+            return Isa::mulAdd(blend, carrier, oneMinusBlend);
+    }
+
+    void advance() noexcept
+    {
+        PhaseLanes<Isa, Ramped>::advance();
+
+        if constexpr (Ramped)
+            blend = Isa::add(blend, blendDelta);
+    }
+
+    Float blend, oneMinusBlend {}, blendDelta {};
+};
+
+//==============================================================================
+// Input peak for the envelope follower (Detect kernels): max |x| over the
+// samples a pass has loaded anyway, kept in a register and folded into
+// *peak once per pass. Compiles away when not detecting.
+//==============================================================================
+template <typename Isa, bool Detect>
+struct PeakLanes
+{
+    void add(typename Isa::Float) noexcept {}
+    void store(typename Isa::Scalar*) const noexcept {}
+};
+
+template <typename Isa>
+struct PeakLanes<Isa, true>
+{
+    using Scalar = typename Isa::Scalar;
+
+    PeakLanes() noexcept : peak(Isa::set(Scalar(0))) {}
+
+    void add(typename Isa::Float input) noexcept { peak = Isa::max(peak, Isa::abs(input)); }
+
+    void store(Scalar* result) const noexcept
+    {
+        alignas(64) Scalar lanes[Isa::width];
+        Isa::store(lanes, peak);
+
+        for (const auto lane : lanes)
+            *result = lane > *result ? lane : *result;
+    }
+
+    typename Isa::Float peak;
+};
+
+//==============================================================================
+// Carrier computed in registers and applied to a fixed number of channels.
+// With one input and two outputs the mono result is written to both.
+// Processes [begin, end) in whole registers and returns where it stopped.
+//==============================================================================
+template <typename Isa, typename Carrier, int Inputs, int Outputs, bool Ramped, bool Detect>
+int fusedPass(const RingModBlock<typename Isa::Scalar>& block, int begin, int end,
+              KernelState<typename Isa::Scalar>& state) noexcept
+{
+    static_assert(Outputs == Inputs || (Inputs == 1 && Outputs == 2), "Only mono can be copied to stereo");
+    using Scalar = typename Isa::Scalar;
+    constexpr int width = Isa::width;
+    LaneParameters<Isa, Ramped> lanes(state, block);
+    PeakLanes<Isa, Detect> peak;
+
+    int i = begin;
+    for (; i + width <= end; i += width)
+    {
+        const auto gain = lanes.gain(Carrier::template eval<Isa>(lanes.phase, block.table));
+
+        for (int channel = 0; channel < Inputs; ++channel)
+        {
+            Scalar* data = block.channels[channel] + block.startSample + i;
+            const auto input = Isa::load(data);
+            const auto result = Isa::mul(input, gain);
+            peak.add(input);
+            Isa::store(data, result);
+
+            if constexpr (Outputs > Inputs)
+                Isa::store(block.channels[1] + block.startSample + i, result);
+        }
+
+        lanes.advance();
+    }
+
+    peak.store(block.peak);
+    state.advance(i - begin, Ramped ? block.phaseIncStep : 0, Ramped ? block.blendStep : Scalar(0));
+    return i;
+}
+
+//==============================================================================
+// Gain (carrier already blended) rendered once into the modulator scratch,
+// then multiplied into every channel
+//==============================================================================
+template <typename Isa, typename Carrier, bool Ramped>
+int renderPass(const RingModBlock<typename Isa::Scalar>& block, int begin, int end,
+               KernelState<typename Isa::Scalar>& state) noexcept
+{
+    using Scalar = typename Isa::Scalar;
+    constexpr int width = Isa::width;
+    LaneParameters<Isa, Ramped> lanes(state, block);
+
+    int i = begin;
+    for (; i + width <= end; i += width)
+    {
+        Isa::store(block.modulator + i, lanes.gain(Carrier::template eval<Isa>(lanes.phase, block.table)));
+        lanes.advance();
+    }
+
+    state.advance(i - begin, Ramped ? block.phaseIncStep : 0, Ramped ? block.blendStep : Scalar(0));
+    return i;
+}
+
+template <typename Isa, bool Detect>
+int gainPass(typename Isa::Scalar* data, const typename Isa::Scalar* gain, int begin, int end,
+             typename Isa::Scalar* peakOut) noexcept
+{
+    constexpr int width = Isa::width;
+    PeakLanes<Isa, Detect> peak;
+
+    int i = begin;
+    for (; i + width <= end; i += width)
+    {
+        const auto input = Isa::load(data + i);
+        peak.add(input);
+        Isa::store(data + i, Isa::mul(input, Isa::load(gain + i)));
+    }
+
+    peak.store(peakOut);
+    return i;
+}
+
+//==============================================================================
+// Spread sine: sin(a + b) = sin a cos b + cos a sin b, so the base carrier
+// is rendered once as dry = 1 - blend, wetSin = blend * sin and
+// wetCos = blend * cos, and each channel's gain is two multiply-adds
+//==============================================================================
+template <typename Isa, bool Ramped>
+int rotationRenderPass(const RingModBlock<typename Isa::Scalar>& block, typename Isa::Scalar* const* streams,
+                       int begin, int end, KernelState<typename Isa::Scalar>& state) noexcept
+{
+    using Scalar = typename Isa::Scalar;
+    constexpr int width = Isa::width;
+    LaneParameters<Isa, Ramped> lanes(state, block);
+    const auto quarter = Isa::setU(0x40000000u);
+    const auto one = Isa::set(Scalar(1));
+
+    int i = begin;
+    for (; i + width <= end; i += width)
+    {
+        Isa::store(streams[0] + i, Isa::sub(one, lanes.blend));
+        Isa::store(streams[1] + i, Isa::mul(lanes.blend, SimdWaveforms<Isa>::sine(lanes.phase)));
+        Isa::store(streams[2] + i, Isa::mul(lanes.blend, SimdWaveforms<Isa>::sine(Isa::addU(lanes.phase, quarter))));
+        lanes.advance();
+    }
+
+    state.advance(i - begin, Ramped ? block.phaseIncStep : 0, Ramped ? block.blendStep : Scalar(0));
+    return i;
+}
+
+// Channels rotated per pass, so the streams are loaded once for the group
+constexpr int rotationGroup = 4;
+
+template <typename Isa, int Channels, bool Detect>
+int rotationGainPass(typename Isa::Scalar* const* data, const typename Isa::Scalar* const* streams,
+                     const typename Isa::Scalar* cosOffsets, const typename Isa::Scalar* sinOffsets,
+                     int begin, int end, typename Isa::Scalar* peakOut) noexcept
+{
+    constexpr int width = Isa::width;
+    PeakLanes<Isa, Detect> peak;
+
+    int i = begin;
+    for (; i + width <= end; i += width)
+    {
+        const auto dry = Isa::load(streams[0] + i);
+        const auto wetSin = Isa::load(streams[1] + i);
+        const auto wetCos = Isa::load(streams[2] + i);
+
+        for (int channel = 0; channel < Channels; ++channel)
+        {
+            const auto gain = Isa::mulAdd(wetSin, Isa::set(cosOffsets[channel]),
+                                          Isa::mulAdd(wetCos, Isa::set(sinOffsets[channel]), dry));
+            const auto input = Isa::load(data[channel] + i);
+            peak.add(input);
+            Isa::store(data[channel] + i, Isa::mul(input, gain));
+        }
+    }
+
+    peak.store(peakOut);
+    return i;
+}
+
+template <typename Isa, int Channels, bool Detect>
+void rotationGain(typename Isa::Scalar* const* data, const typename Isa::Scalar* const* streams,
+                  const typename Isa::Scalar* cosOffsets, const typename Isa::Scalar* sinOffsets, int numSamples,
+                  typename Isa::Scalar* peakOut) noexcept
+{
+    using Tail = SimdScalarLanes<Isa, typename Isa::Scalar>;
+    const int done = rotationGainPass<Isa, Channels, Detect>(data, streams, cosOffsets, sinOffsets, 0, numSamples, peakOut);
+    rotationGainPass<Tail, Channels, Detect>(data, streams, cosOffsets, sinOffsets, done, numSamples, peakOut);
+}
+
+//==============================================================================
+// Kernels: vector body plus a one-lane tail running the same maths
+//==============================================================================
+template <typename Isa, typename Carrier, int Inputs, int Outputs, bool Ramped, bool Detect>
+uint32_t fusedKernel(const RingModBlock<typename Isa::Scalar>& block, uint32_t phase, uint32_t phaseInc) noexcept
+{
+    using Tail = SimdScalarLanes<Isa, typename Isa::Scalar>;
+    KernelState<typename Isa::Scalar> state { phase, phaseInc, block.blend };
+
+    const int done = fusedPass<Isa, Carrier, Inputs, Outputs, Ramped, Detect>(block, 0, block.numSamples, state);
+    fusedPass<Tail, Carrier, Inputs, Outputs, Ramped, Detect>(block, done, block.numSamples, state);
+    return state.phase;
+}
+
+template <typename Isa, typename Carrier, bool Ramped, bool Detect>
+uint32_t multichannelKernel(const RingModBlock<typename Isa::Scalar>& block, uint32_t phase, uint32_t phaseInc) noexcept
+{
+    using Tail = SimdScalarLanes<Isa, typename Isa::Scalar>;
+    KernelState<typename Isa::Scalar> state { phase, phaseInc, block.blend };
+
+    for (int start = 0; start < block.numSamples; start += block.modulatorSize)
+    {
+        const int chunk = block.numSamples - start < block.modulatorSize
+                            ? block.numSamples - start : block.modulatorSize;
+
+        const int done = renderPass<Isa, Carrier, Ramped>(block, 0, chunk, state);
+        renderPass<Tail, Carrier, Ramped>(block, done, chunk, state);
+
+        for (int channel = 0; channel < block.numChannels; ++channel)
+        {
+            auto* data = block.channels[channel] + block.startSample + start;
+            const int multiplied = gainPass<Isa, Detect>(data, block.modulator, 0, chunk, block.peak);
+            gainPass<Tail, Detect>(data, block.modulator, multiplied, chunk, block.peak);
+        }
+    }
+
+    return state.phase;
+}
+
+template <typename Isa, typename Carrier, bool Ramped, bool Detect>
+uint32_t spreadKernel(const RingModBlock<typename Isa::Scalar>& block, uint32_t phase, uint32_t phaseInc) noexcept
+{
+    using Scalar = typename Isa::Scalar;
+    using Tail = SimdScalarLanes<Isa, Scalar>;
+    KernelState<Scalar> state { phase, phaseInc, block.blend };
+
+    if constexpr (Carrier::rotates)
+    {
+        // Three streams, each starting on a 64-byte boundary
+        const int chunkSize = block.modulatorSize / 3 / 16 * 16;
+        Scalar* const streams[3] = { block.modulator, block.modulator + chunkSize, block.modulator + 2 * chunkSize };
+
+        for (int start = 0; start < block.numSamples; start += chunkSize)
+        {
+            const int chunk = block.numSamples - start < chunkSize ? block.numSamples - start : chunkSize;
+
+            const int done = rotationRenderPass<Isa, Ramped>(block, streams, 0, chunk, state);
+            rotationRenderPass<Tail, Ramped>(block, streams, done, chunk, state);
+
+            for (int first = 0; first < block.numChannels; first += rotationGroup)
+            {
+                const int count = block.numChannels - first < rotationGroup ? block.numChannels - first : rotationGroup;
+                Scalar* data[rotationGroup];
+                Scalar cosOffsets[rotationGroup], sinOffsets[rotationGroup];
+
+                for (int k = 0; k < count; ++k)
+                {
+                    const uint32_t offset = block.phaseOffsets[first + k];
+                    sinOffsets[k] = SimdWaveforms<Tail>::sine(offset);
+                    cosOffsets[k] = SimdWaveforms<Tail>::sine(offset + 0x40000000u);
+                    data[k] = block.channels[first + k] + block.startSample + start;
+                }
+
+                switch (count)
+                {
+                case 1:  rotationGain<Isa, 1, Detect>(data, streams, cosOffsets, sinOffsets, chunk, block.peak); break;
+                case 2:  rotationGain<Isa, 2, Detect>(data, streams, cosOffsets, sinOffsets, chunk, block.peak); break;
+                case 3:  rotationGain<Isa, 3, Detect>(data, streams, cosOffsets, sinOffsets, chunk, block.peak); break;
+                default: rotationGain<Isa, 4, Detect>(data, streams, cosOffsets, sinOffsets, chunk, block.peak); break;
+                }
+            }
+        }
+    }
+    else
+    {
+        // No shortcut for the other shapes: each channel runs at its own phase
+        for (int channel = 0; channel < block.numChannels; ++channel)
+        {
+            auto single = block;
+            single.channels = block.channels + channel;
+            single.numChannels = 1;
+            fusedKernel<Isa, Carrier, 1, 1, Ramped, Detect>(single, phase + block.phaseOffsets[channel], phaseInc);
+        }
+
+        state.advance(block.numSamples, Ramped ? block.phaseIncStep : 0, Ramped ? block.blendStep : Scalar(0));
+    }
+
+    return state.phase;
+}
+
+//==============================================================================
+// Carrier bank: per register of samples, every carrier's shape at its own
+// phases, scaled by its level and summed. Carriers are laid out by shape
+// so each run is a branch-free loop over contiguous arrays; the blended
+// sum goes to the modulator scratch like the multichannel kernel.
+//==============================================================================
+template <typename Isa, bool Ramped>
+int bankRenderPass(const RingModBlock<typename Isa::Scalar>& block, CarrierBank& bank, int begin, int end,
+                   KernelState<typename Isa::Scalar>& state) noexcept
+{
+    using Scalar = typename Isa::Scalar;
+    using Float = typename Isa::Float;
+    constexpr int width = Isa::width;
+
+    PhaseLanes<Isa, Ramped> carriers[CarrierBank::maxCarriers];
+    Float levels[CarrierBank::maxCarriers];
+    const int numCarriers = bank.numCarriers;
+
+    for (int k = 0; k < numCarriers; ++k)
+    {
+        carriers[k] = PhaseLanes<Isa, Ramped>(bank.phase[k], bank.phaseInc[k], Ramped ? bank.phaseIncStep[k] : 0);
+        levels[k] = Isa::set(static_cast<Scalar>(bank.level[k]));
+    }
+
+    LaneParameters<Isa, Ramped> lanes(state, block);
+    const int sineEnd = bank.waveformEnd[0];
+    const int triangleEnd = bank.waveformEnd[1];
+
+    int i = begin;
+    for (; i + width <= end; i += width)
+    {
+        // Separate sums per shape keep the multiply-add chains short
+        auto sines = Isa::set(Scalar(0)), triangles = sines, squares = sines;
+        int k = 0;
+
+        for (; k < sineEnd; ++k)
+        {
+            sines = Isa::mulAdd(levels[k], SimdWaveforms<Isa>::sine(carriers[k].phase), sines);
+            carriers[k].advance();
+        }
+
+        for (; k < triangleEnd; ++k)
+        {
+            triangles = Isa::mulAdd(levels[k], SimdWaveforms<Isa>::triangle(carriers[k].phase), triangles);
+            carriers[k].advance();
+        }
+
+        for (; k < numCarriers; ++k)
+        {
+            squares = Isa::mulAdd(levels[k], SimdWaveforms<Isa>::square(carriers[k].phase), squares);
+            carriers[k].advance();
+        }
+
+        Isa::store(block.modulator + i, lanes.gain(Isa::add(sines, Isa::add(triangles, squares))));
+        lanes.advance();
+    }
+
+    // Same closed form as the single carrier, per carrier
+    const int done = i - begin;
+
+    for (int k = 0; k < numCarriers; ++k)
+    {
+        KernelState<Scalar> carrier { bank.phase[k], bank.phaseInc[k], Scalar(0) };
+        carrier.advance(done, Ramped ? bank.phaseIncStep[k] : 0, Scalar(0));
+        bank.phase[k] = carrier.phase;
+        bank.phaseInc[k] = carrier.phaseInc;
+    }
+
+    state.advance(done, 0, Ramped ? block.blendStep : Scalar(0));
+    return i;
+}
+
+template <typename Isa, bool Ramped, bool Detect>
+void carrierBankKernel(const RingModBlock<typename Isa::Scalar>& block, CarrierBank& bank) noexcept
+{
+    using Tail = SimdScalarLanes<Isa, typename Isa::Scalar>;
+    KernelState<typename Isa::Scalar> state { 0, 0, block.blend };
+
+    for (int start = 0; start < block.numSamples; start += block.modulatorSize)
+    {
+        const int chunk = block.numSamples - start < block.modulatorSize
+                            ? block.numSamples - start : block.modulatorSize;
+
+        const int done = bankRenderPass<Isa, Ramped>(block, bank, 0, chunk, state);
+        bankRenderPass<Tail, Ramped>(block, bank, done, chunk, state);
+
+        for (int channel = 0; channel < block.numChannels; ++channel)
+        {
+            auto* data = block.channels[channel] + block.startSample + start;
+            const int multiplied = gainPass<Isa, Detect>(data, block.modulator, 0, chunk, block.peak);
+            gainPass<Tail, Detect>(data, block.modulator, multiplied, chunk, block.peak);
+        }
+    }
+}
+
+template <typename Isa>
+CarrierBankKernel<typename Isa::Scalar> getBankKernel(bool ramped, bool detect) noexcept
+{
+    if (detect)
+        return ramped ? carrierBankKernel<Isa, true, true> : carrierBankKernel<Isa, false, true>;
+
+    return ramped ? carrierBankKernel<Isa, true, false> : carrierBankKernel<Isa, false, false>;
+}
+
+//==============================================================================
+// Voice batch: one register holds one sample of width voices. A tile of
+// width samples is rendered, transposed so a register holds one voice's
+// run of samples, and applied to that voice's channels as they lie.
+//==============================================================================
+template <typename Isa, typename Carrier, bool Ramped>
+int voiceBatchPass(const RingModVoiceBlock<typename Isa::Scalar>& block, int begin, int end) noexcept
+{
+    using Scalar = typename Isa::Scalar;
+    constexpr int width = Isa::width;
+    const auto one = Isa::set(Scalar(1));
+    const int cpv = block.channelsPerVoice;
+
+    int v = begin;
+    for (; v + width <= end; v += width)
+    {
+        auto phase = Isa::loadU(block.phase + v);
+        auto phaseInc = Isa::loadU(block.phaseInc + v);
+        auto blend = Isa::load(block.blend + v);
+        typename Isa::UInt phaseIncStep {};
+        typename Isa::Float blendStep {};
+
+        if constexpr (Ramped)
+        {
+            phaseIncStep = Isa::loadU(reinterpret_cast<const uint32_t*>(block.phaseIncStep + v));
+            blendStep = Isa::load(block.blendStep + v);
+        }
+
+        const auto nextGain = [&]
+        {
+            const auto gain = Isa::mulAdd(blend, Carrier::template eval<Isa>(phase, nullptr), Isa::sub(one, blend));
+            phase = Isa::addU(phase, phaseInc);
+
+            if constexpr (Ramped)
+            {
+                phaseInc = Isa::addU(phaseInc, phaseIncStep);
+                blend = Isa::add(blend, blendStep);
+            }
+
+            return gain;
+        };
+
+        Scalar* const* channels = block.channels + v * cpv;
+
+        // Whole tiles: a row per sample, a column per voice, turned round
+        int i = 0;
+        for (; i + width <= block.numSamples; i += width)
+        {
+            typename Isa::Float tile[width];
+
+            for (int k = 0; k < width; ++k)
+                tile[k] = nextGain();
+
+            Isa::transpose(tile);
+
+            for (int lane = 0; lane < width; ++lane)
+            {
+                for (int channel = 0; channel < cpv; ++channel)
+                {
+                    Scalar* data = channels[lane * cpv + channel] + i;
+                    Isa::store(data, Isa::mul(Isa::load(data), tile[lane]));
+                }
+            }
+        }
+
+        // The last few samples through the scratch, a voice per lane
+        const int remaining = block.numSamples - i;
+
+        for (int k = 0; k < remaining; ++k)
+            Isa::store(block.gains + k * width, nextGain());
+
+        for (int lane = 0; lane < width && remaining > 0; ++lane)
+            for (int channel = 0; channel < cpv; ++channel)
+                for (int k = 0; k < remaining; ++k)
+                    channels[lane * cpv + channel][i + k] *= block.gains[k * width + lane];
+    }
+
+    return v;
+}
+
+template <typename Isa, bool Ramped>
+void voiceBatchKernel(const RingModVoiceBlock<typename Isa::Scalar>& block) noexcept
+{
+    using Tail = SimdScalarLanes<Isa, typename Isa::Scalar>;
+    using Sine = PolynomialCarrier<DdsWaveform::Sine>;
+    using Triangle = PolynomialCarrier<DdsWaveform::Triangle>;
+    using Square = PolynomialCarrier<DdsWaveform::Square>;
+    const int sineEnd = block.waveformEnd[0];
+    const int triangleEnd = block.waveformEnd[1];
+
+    int done = voiceBatchPass<Isa, Sine, Ramped>(block, 0, sineEnd);
+    voiceBatchPass<Tail, Sine, Ramped>(block, done, sineEnd);
+
+    done = voiceBatchPass<Isa, Triangle, Ramped>(block, sineEnd, triangleEnd);
+    voiceBatchPass<Tail, Triangle, Ramped>(block, done, triangleEnd);
+
+    done = voiceBatchPass<Isa, Square, Ramped>(block, triangleEnd, block.numVoices);
+    voiceBatchPass<Tail, Square, Ramped>(block, done, block.numVoices);
+}
+
+template <typename Isa>
+VoiceBatchKernel<typename Isa::Scalar> getBatchKernel(bool ramped) noexcept
+{
+    return ramped ? voiceBatchKernel<Isa, true> : voiceBatchKernel<Isa, false>;
+}
+
+//==============================================================================
+// Sidechain carrier: the blend gain taken from a buffer instead of an
+// oscillator. The unused phase lanes cost one add per register.
+//==============================================================================
+template <typename Isa, bool Connected, bool Ramped>
+int sidechainPass(const RingModBlock<typename Isa::Scalar>& block, typename Isa::Scalar* data,
+                  const typename Isa::Scalar* carrier, int begin, int end,
+                  KernelState<typename Isa::Scalar>& state) noexcept
+{
+    using Scalar = typename Isa::Scalar;
+    constexpr int width = Isa::width;
+    LaneParameters<Isa, Ramped> lanes(state, block);
+
+    int i = begin;
+    for (; i + width <= end; i += width)
+    {
+        const auto gain = lanes.gain(Connected ? Isa::load(carrier + i) : Isa::set(Scalar(0)));
+        Isa::store(data + i, Isa::mul(Isa::load(data + i), gain));
+        lanes.advance();
+    }
+
+    state.advance(i - begin, 0, Ramped ? block.blendStep : Scalar(0));
+    return i;
+}
+
+template <typename Isa, bool Ramped>
+int sidechainStereoPass(const RingModBlock<typename Isa::Scalar>& block, const typename Isa::Scalar* const* carriers,
+                        int begin, int end, KernelState<typename Isa::Scalar>& state) noexcept
+{
+    using Scalar = typename Isa::Scalar;
+    constexpr int width = Isa::width;
+    LaneParameters<Isa, Ramped> lanes(state, block);
+
+    Scalar* const left = block.channels[0] + block.startSample;
+    Scalar* const right = block.channels[1] + block.startSample;
+    const Scalar* const leftCarrier = carriers[0] + block.startSample;
+    const Scalar* const rightCarrier = carriers[1] + block.startSample;
+
+    int i = begin;
+    for (; i + width <= end; i += width)
+    {
+        const auto input = Isa::load(left + i);
+        const auto leftGain = lanes.gain(Isa::load(leftCarrier + i));
+        const auto rightGain = lanes.gain(Isa::load(rightCarrier + i));
+        Isa::store(left + i, Isa::mul(input, leftGain));
+        Isa::store(right + i, Isa::mul(input, rightGain));
+        lanes.advance();
+    }
+
+    state.advance(i - begin, 0, Ramped ? block.blendStep : Scalar(0));
+    return i;
+}
+
+template <typename Isa, bool Connected, bool Ramped>
+void sidechainKernel(const RingModBlock<typename Isa::Scalar>& block, const typename Isa::Scalar* const* carriers) noexcept
+{
+    using Scalar = typename Isa::Scalar;
+    using Tail = SimdScalarLanes<Isa, Scalar>;
+
+    for (int channel = 0; channel < block.numChannels; ++channel)
+    {
+        KernelState<Scalar> state { 0, 0, block.blend };
+        Scalar* data = block.channels[channel] + block.startSample;
+        const Scalar* carrier = Connected ? carriers[channel] + block.startSample : nullptr;
+
+        const int done = sidechainPass<Isa, Connected, Ramped>(block, data, carrier, 0, block.numSamples, state);
+        sidechainPass<Tail, Connected, Ramped>(block, data, carrier, done, block.numSamples, state);
+    }
+}
+
+template <typename Isa, bool Ramped>
+void sidechainStereoKernel(const RingModBlock<typename Isa::Scalar>& block, const typename Isa::Scalar* const* carriers) noexcept
+{
+    using Tail = SimdScalarLanes<Isa, typename Isa::Scalar>;
+    KernelState<typename Isa::Scalar> state { 0, 0, block.blend };
+
+    const int done = sidechainStereoPass<Isa, Ramped>(block, carriers, 0, block.numSamples, state);
+    sidechainStereoPass<Tail, Ramped>(block, carriers, done, block.numSamples, state);
+}
+
+template <typename Isa>
+SidechainKernel<typename Isa::Scalar> getExternalKernel(RingModChannels channels, bool connected, bool ramped) noexcept
+{
+    // Unconnected mono-to-stereo never gets here: with nothing to read
+    // first, the caller copies channel 0 across and runs per channel
+    if (connected && channels == RingModChannels::MonoToStereo)
+        return ramped ? sidechainStereoKernel<Isa, true> : sidechainStereoKernel<Isa, false>;
+
+    if (connected)
+        return ramped ? sidechainKernel<Isa, true, true> : sidechainKernel<Isa, true, false>;
+
+    return ramped ? sidechainKernel<Isa, false, true> : sidechainKernel<Isa, false, false>;
+}
+
+//==============================================================================
+// One instruction set's kernels: [waveform][RingModChannels]
+//==============================================================================
+template <typename Isa, typename Carrier, bool Ramped, bool Detect>
+constexpr RingModKernel<typename Isa::Scalar> kernelRow[5] = {
+    fusedKernel<Isa, Carrier, 1, 1, Ramped, Detect>,
+    fusedKernel<Isa, Carrier, 2, 2, Ramped, Detect>,
+    multichannelKernel<Isa, Carrier, Ramped, Detect>,
+    fusedKernel<Isa, Carrier, 1, 2, Ramped, Detect>,
+    spreadKernel<Isa, Carrier, Ramped, Detect>
+};
+
+template <typename Isa, bool Ramped, bool Detect>
+constexpr const RingModKernel<typename Isa::Scalar>* polynomialRows[3] = {
+    kernelRow<Isa, PolynomialCarrier<DdsWaveform::Sine>, Ramped, Detect>,
+    kernelRow<Isa, PolynomialCarrier<DdsWaveform::Triangle>, Ramped, Detect>,
+    kernelRow<Isa, PolynomialCarrier<DdsWaveform::Square>, Ramped, Detect>
+};
+
+template <typename Isa>
+RingModKernel<typename Isa::Scalar> getPolynomialKernel(DdsWaveform waveform, RingModChannels channels,
+                                                        bool ramped, bool detect) noexcept
+{
+    const int shape = static_cast<int>(waveform);
+    const int layout = static_cast<int>(channels);
+
+    if (detect)
+        return ramped ? polynomialRows<Isa, true, true>[shape][layout]
+                      : polynomialRows<Isa, false, true>[shape][layout];
+
+    return ramped ? polynomialRows<Isa, true, false>[shape][layout]
+                  : polynomialRows<Isa, false, false>[shape][layout];
+}
+
+//==============================================================================
+// SHARC ADSP-21160 arithmetic on double lanes: every result rounded to
+// nearest even at 24 significant bits (32-bit float) or 32 (40-bit
+// extended), flushed to zero below the smallest normal and taken to
+// infinity past the largest, as the DSP does. The rounding works on the raw bits, so the vector body and the
+// one-lane tail agree bit for bit on every instruction set. Rounding a
+// double result again is exact for 24 bits; for 32 the rounding error of
+// the double operation is worked out and folded in first (round to odd),
+// so ties still go the way a single rounding would take them.
+//==============================================================================
+template <typename Isa, bool Extended>
+struct SharcArithmetic
+{
+    using Float = typename Isa::Float;
+    static constexpr int dropBits = Extended ? 53 - 32 : 53 - 24;
+
+    // Round to nearest even, keeping 53 - Drop significant bits
+    template <int Drop>
+    static Float round(Float v) noexcept
+    {
+        const auto bits = Isa::asBits(v);
+        const auto odd = Isa::andB(Isa::template shiftRightB<Drop>(bits), Isa::setB(1));
+        const auto rounded = Isa::addB(bits, Isa::addB(odd, Isa::setB((uint64_t(1) << (Drop - 1)) - 1)));
+        return Isa::fromBits(Isa::andNotB(Isa::setB((uint64_t(1) << Drop) - 1), rounded));
+    }
+
+    // Nudges an even v by one unit towards v + error when error is not zero
+    static Float roundToOdd(Float v, Float error) noexcept
+    {
+        const auto one = Isa::setB(1);
+        const auto zero = Isa::set(0.0);
+        const auto even = Isa::andNotB(Isa::asBits(v), one);
+        const auto towards = Isa::mul(error, Isa::copySign(Isa::set(1.0), v));
+        const auto up = Isa::andB(Isa::lessMask(zero, towards), even);
+        const auto down = Isa::andB(Isa::lessMask(towards, zero), even);
+        return Isa::fromBits(Isa::subB(Isa::addB(Isa::asBits(v), up), down));
+    }
+
+    // Rounded results are either within the 8-bit exponent's range or at
+    // least 2^128; NaN passes through
+    static Float flush(Float v) noexcept
+    {
+        const auto magnitude = Isa::abs(v);
+        const auto tiny = Isa::lessMask(magnitude, Isa::set(0x1p-126));
+        const auto huge = Isa::lessMask(Isa::set(0x1.fffffffffffffp127), magnitude);
+        const auto infinity = Isa::asBits(Isa::copySign(Isa::set(HUGE_VAL), v));
+        const auto kept = Isa::andNotB(huge, Isa::andNotB(tiny, Isa::asBits(v)));
+        return Isa::fromBits(Isa::addB(kept, Isa::andB(huge, infinity)));
+    }
+
+    static Float add(Float a, Float b) noexcept
+    {
+        auto sum = Isa::add(a, b);
+
+        if constexpr (Extended)
+        {
+            // Knuth's two-sum: the exact error of the double addition
+            const auto bPart = Isa::sub(sum, a);
+            const auto aPart = Isa::sub(sum, bPart);
+            sum = roundToOdd(sum, Isa::add(Isa::sub(a, aPart), Isa::sub(b, bPart)));
+        }
+
+        return flush(round<dropBits>(sum));
+    }
+
+    static Float sub(Float a, Float b) noexcept { return add(a, Isa::sub(Isa::set(0.0), b)); }
+
+    static Float mul(Float a, Float b) noexcept
+    {
+        auto product = Isa::mul(a, b);
+
+        if constexpr (Extended)
+        {
+            // Dekker's product error, operands split into 16-bit halves so
+            // every partial product is exact
+            const auto aHigh = round<37>(a), aLow = Isa::sub(a, aHigh);
+            const auto bHigh = round<37>(b), bLow = Isa::sub(b, bHigh);
+            auto error = Isa::sub(Isa::mul(aHigh, bHigh), product);
+            error = Isa::add(error, Isa::mul(aHigh, bLow));
+            error = Isa::add(error, Isa::mul(aLow, bHigh));
+            error = Isa::add(error, Isa::mul(aLow, bLow));
+            product = roundToOdd(product, error);
+        }
+
+        return flush(round<dropBits>(product));
+    }
+
+    // Samples as the DSP's 32-bit float data memory holds them
+    static Float toMemory(Float v) noexcept { return flush(round<53 - 24>(v)); }
+    static Float load(const float* p) noexcept { return flush(Isa::loadFloat(p)); }
+    static Float load(const double* p) noexcept { return toMemory(Isa::load(p)); }
+    static void store(float* p, Float v) noexcept { Isa::storeFloat(p, toMemory(v)); }
+    static void store(double* p, Float v) noexcept { Isa::store(p, toMemory(v)); }
+};
+
+//==============================================================================
+// SHARC emulation: the authentic interpolated table lookup, blend and
+// multiply in the DSP's arithmetic, on a 32-bit phase accumulator. Runs on
+// double lanes whatever the sample type. The blend ramp is evaluated per
+// sample from the block's start (blend + n * blendStep in DSP arithmetic)
+// so results do not depend on how the block was cut into registers.
+//==============================================================================
+template <typename Isa, typename SampleType, bool Extended, bool MonoToStereo, bool Ramped, bool Detect>
+int sharcPass(const RingModBlock<SampleType>& block, int begin, int end, KernelState<SampleType>& state) noexcept
+{
+    using Sharc = SharcArithmetic<Isa, Extended>;
+    constexpr int width = Isa::width;
+    PhaseLanes<Isa, Ramped> phases(state.phase, state.phaseInc, block.phaseIncStep);
+    PeakLanes<Isa, Detect> peak;
+
+    const auto one = Isa::set(1.0);
+    const auto fracMask = Isa::setU(DdsWaveTables::fracMask);
+    const auto fracScale = Isa::set(1.0 / static_cast<double>(1u << DdsWaveTables::fracBits));
+    const auto blend = Sharc::toMemory(Isa::set(static_cast<double>(block.blend)));
+    const auto blendStep = Sharc::toMemory(Isa::set(static_cast<double>(block.blendStep)));
+    const int numInputs = MonoToStereo ? 1 : block.numChannels;
+
+    int i = begin;
+    for (; i + width <= end; i += width)
+    {
+        // Top bits index the table, the rest (exact in a double) interpolate
+        const auto index = Isa::template shiftRightU<DdsWaveTables::fracBits>(phases.phase);
+        const auto frac = Isa::mul(Isa::fromSigned(Isa::andU(phases.phase, fracMask)), fracScale);
+        const auto a = Isa::gather(block.table, index);
+        const auto carrier = Sharc::add(a, Sharc::mul(frac, Sharc::sub(Isa::gather(block.table + 1, index), a)));
+
+        auto laneBlend = blend;
+        if constexpr (Ramped)
+            laneBlend = Sharc::add(blend, Sharc::mul(Isa::fromSigned(Isa::rampU(static_cast<uint32_t>(i), 1u)), blendStep));
+
+        const auto gain = Sharc::add(Sharc::mul(laneBlend, carrier), Sharc::sub(one, laneBlend));
+
+        for (int channel = 0; channel < numInputs; ++channel)
+        {
+            SampleType* data = block.channels[channel] + block.startSample + i;
+            const auto input = Sharc::load(data);
+            const auto result = Sharc::mul(input, gain);
+            peak.add(input);
+            Sharc::store(data, result);
+
+            if constexpr (MonoToStereo)
+                Sharc::store(block.channels[1] + block.startSample + i, result);
+        }
+
+        phases.advance();
+    }
+
+    if constexpr (Detect)
+    {
+        double lanePeak = static_cast<double>(*block.peak);
+        peak.store(&lanePeak);
+        *block.peak = static_cast<SampleType>(lanePeak);
+    }
+
+    state.advance(i - begin, Ramped ? block.phaseIncStep : 0, SampleType(0));
+    return i;
+}
+
+template <typename Isa, typename SampleType, bool Extended, bool MonoToStereo, bool Ramped, bool Detect>
+uint32_t sharcKernel(const RingModBlock<SampleType>& block, uint32_t phase, uint32_t phaseInc) noexcept
+{
+    using Tail = SimdScalarLanes<Isa, double>;
+    KernelState<SampleType> state { phase, phaseInc, block.blend };
+
+    const int done = sharcPass<Isa, SampleType, Extended, MonoToStereo, Ramped, Detect>(block, 0, block.numSamples, state);
+    sharcPass<Tail, SampleType, Extended, MonoToStereo, Ramped, Detect>(block, done, block.numSamples, state);
+    return state.phase;
+}
+
+// Each channel at its own phase
+template <typename Isa, typename SampleType, bool Extended, bool Ramped, bool Detect>
+uint32_t sharcSpreadKernel(const RingModBlock<SampleType>& block, uint32_t phase, uint32_t phaseInc) noexcept
+{
+    KernelState<SampleType> state { phase, phaseInc, block.blend };
+
+    for (int channel = 0; channel < block.numChannels; ++channel)
+    {
+        auto single = block;
+        single.channels = block.channels + channel;
+        single.numChannels = 1;
+        sharcKernel<Isa, SampleType, Extended, false, Ramped, Detect>(single, phase + block.phaseOffsets[channel], phaseInc);
+    }
+
+    state.advance(block.numSamples, Ramped ? block.phaseIncStep : 0, SampleType(0));
+    return state.phase;
+}
+
+template <typename Isa, typename SampleType, bool Extended, bool Ramped, bool Detect>
+constexpr RingModKernel<SampleType> sharcRow[5] = {
+    sharcKernel<Isa, SampleType, Extended, false, Ramped, Detect>,
+    sharcKernel<Isa, SampleType, Extended, false, Ramped, Detect>,
+    sharcKernel<Isa, SampleType, Extended, false, Ramped, Detect>,
+    sharcKernel<Isa, SampleType, Extended, true, Ramped, Detect>,
+    sharcSpreadKernel<Isa, SampleType, Extended, Ramped, Detect>
+};
+
+template <typename Isa, typename SampleType, bool Ramped, bool Detect>
+constexpr const RingModKernel<SampleType>* sharcRows[2] = {
+    sharcRow<Isa, SampleType, false, Ramped, Detect>,
+    sharcRow<Isa, SampleType, true, Ramped, Detect>
+};
+
+// Isa is a double-lane type; SampleType is the block's
+template <typename Isa, typename SampleType>
+RingModKernel<SampleType> getSharcKernel(RingModChannels channels, bool extended, bool ramped, bool detect) noexcept
+{
+    const int precision = extended ? 1 : 0;
+    const int layout = static_cast<int>(channels);
+
+    if (detect)
+        return ramped ? sharcRows<Isa, SampleType, true, true>[precision][layout]
+                      : sharcRows<Isa, SampleType, false, true>[precision][layout];
+
+    return ramped ? sharcRows<Isa, SampleType, true, false>[precision][layout]
+                  : sharcRows<Isa, SampleType, false, false>[precision][layout];
+}
+
+//==============================================================================
+// Oversampling filter FIR: out[k] = sum_i coeffs[i] * input[k + i].
+// The wide pass keeps four registers of outputs (four independent
+// multiply-add chains) in flight; the taps are broadcast, the input is
+// read unaligned.
+//==============================================================================
+template <typename Isa>
+int firPassWide(const typename Isa::Scalar* input, const typename Isa::Scalar* coeffs, int numTaps,
+                typename Isa::Scalar* out, int begin, int end) noexcept
+{
+    using Scalar = typename Isa::Scalar;
+    constexpr int width = Isa::width;
+
+    int k = begin;
+    for (; k + 4 * width <= end; k += 4 * width)
+    {
+        auto acc0 = Isa::set(Scalar(0)), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        const Scalar* x = input + k;
+
+        for (int i = 0; i < numTaps; ++i)
+        {
+            const auto c = Isa::set(coeffs[i]);
+            acc0 = Isa::mulAdd(c, Isa::load(x + i), acc0);
+            acc1 = Isa::mulAdd(c, Isa::load(x + i + width), acc1);
+            acc2 = Isa::mulAdd(c, Isa::load(x + i + 2 * width), acc2);
+            acc3 = Isa::mulAdd(c, Isa::load(x + i + 3 * width), acc3);
+        }
+
+        Isa::store(out + k, acc0);
+        Isa::store(out + k + width, acc1);
+        Isa::store(out + k + 2 * width, acc2);
+        Isa::store(out + k + 3 * width, acc3);
+    }
+
+    return k;
+}
+
+template <typename Isa>
+int firPass(const typename Isa::Scalar* input, const typename Isa::Scalar* coeffs, int numTaps,
+            typename Isa::Scalar* out, int begin, int end) noexcept
+{
+    using Scalar = typename Isa::Scalar;
+    constexpr int width = Isa::width;
+
+    int k = begin;
+    for (; k + width <= end; k += width)
+    {
+        auto acc = Isa::set(Scalar(0));
+
+        for (int i = 0; i < numTaps; ++i)
+            acc = Isa::mulAdd(Isa::set(coeffs[i]), Isa::load(input + k + i), acc);
+
+        Isa::store(out + k, acc);
+    }
+
+    return k;
+}
+
+template <typename Isa>
+void firKernel(const typename Isa::Scalar* input, const typename Isa::Scalar* coeffs, int numTaps,
+               typename Isa::Scalar* out, int numOutputs) noexcept
+{
+    using Tail = SimdScalarLanes<Isa, typename Isa::Scalar>;
+
+    int done = firPassWide<Isa>(input, coeffs, numTaps, out, 0, numOutputs);
+    done = firPass<Isa>(input, coeffs, numTaps, out, done, numOutputs);
+    firPass<Tail>(input, coeffs, numTaps, out, done, numOutputs);
+}
+
+// Defined in RingModKernelsAVX2.cpp / RingModKernelsAVX512.cpp (x86 only),
+// instantiated for float and double
+template <typename SampleType>
+RingModKernel<SampleType> getRingModKernelAVX2(DdsWaveform waveform, RingModChannels channels, bool ramped, bool detect) noexcept;
+
+template <typename SampleType>
+RingModKernel<SampleType> getRingModKernelAVX512(DdsWaveform waveform, RingModChannels channels, bool ramped, bool detect) noexcept;
+
+template <typename SampleType>
+CarrierBankKernel<SampleType> getCarrierBankKernelAVX2(bool ramped, bool detect) noexcept;
+
+template <typename SampleType>
+CarrierBankKernel<SampleType> getCarrierBankKernelAVX512(bool ramped, bool detect) noexcept;
+
+template <typename SampleType>
+VoiceBatchKernel<SampleType> getVoiceBatchKernelAVX2(bool ramped) noexcept;
+
+template <typename SampleType>
+VoiceBatchKernel<SampleType> getVoiceBatchKernelAVX512(bool ramped) noexcept;
+
+template <typename SampleType>
+SidechainKernel<SampleType> getSidechainKernelAVX2(RingModChannels channels, bool connected, bool ramped) noexcept;
+
+template <typename SampleType>
+SidechainKernel<SampleType> getSidechainKernelAVX512(RingModChannels channels, bool connected, bool ramped) noexcept;
+
+template <typename SampleType>
+FirKernel<SampleType> getFirKernelAVX2() noexcept;
+
+template <typename SampleType>
+FirKernel<SampleType> getFirKernelAVX512() noexcept;
+
+template <typename SampleType>
+RingModKernel<SampleType> getSharcKernelAVX2(RingModChannels channels, bool extended, bool ramped, bool detect) noexcept;
+
+template <typename SampleType>
+RingModKernel<SampleType> getSharcKernelAVX512(RingModChannels channels, bool extended, bool ramped, bool detect) noexcept;
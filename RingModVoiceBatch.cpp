@@ -0,0 +1,237 @@
+/*
+  DDX3216 Ring Modulator Plugin - Voice Batch Implementation
+*/
+
+#include "RingModVoiceBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include "RingModEngine.h"
+
+namespace
+{
+    // Gain scratch: the tail of one tile of the widest register (16 float lanes)
+    constexpr int gainsSize = 16 * 16;
+}
+
+//==============================================================================
+RingModVoiceBatch::RingModVoiceBatch()
+    : RingModVoiceBatch(getSupportedSimdLevel())
+{
+}
+
+RingModVoiceBatch::RingModVoiceBatch(SimdLevel level)
+    : simdLevel(level)
+{
+}
+
+void RingModVoiceBatch::prepare(double sampleRate, int numVoices, int numChannelsPerVoice)
+{
+    currentSampleRate = sampleRate;
+    maxVoices = std::max(numVoices, 0);
+    channelsPerVoice = std::max(numChannelsPerVoice, 1);
+
+    // 20ms parameter smoothing, as in the engine
+    smoothingSamples = static_cast<int>(std::lround(sampleRate * 0.02));
+
+    const auto voices = static_cast<size_t>(maxVoices);
+    settings.resize(voices);
+    targetIncrements.resize(voices);
+    oscillators.assign(voices, DdsOscillator());
+    phaseIncRamps.assign(voices, ParameterRamp<double>());
+    blendRamps.assign(voices, ParameterRamp<double>());
+
+    slotVoice.assign(voices, 0);
+    slotPhase.allocate(maxVoices);
+    slotPhaseInc.allocate(maxVoices);
+    slotPhaseIncStep.allocate(maxVoices);
+    slotBlend.allocate(maxVoices);
+    slotBlendStep.allocate(maxVoices);
+    slotBlendDouble.allocate(maxVoices);
+    slotBlendStepDouble.allocate(maxVoices);
+    gains.allocate(gainsSize);
+    gainsDouble.allocate(gainsSize);
+    slotChannels.assign(voices * static_cast<size_t>(channelsPerVoice), nullptr);
+    slotChannelsDouble.assign(voices * static_cast<size_t>(channelsPerVoice), nullptr);
+
+    for (int v = 0; v < maxVoices; ++v)
+    {
+        oscillators[static_cast<size_t>(v)].prepare(sampleRate);
+        targetIncrements[static_cast<size_t>(v)] = getTargetIncrement(settings[static_cast<size_t>(v)]);
+        phaseIncRamps[static_cast<size_t>(v)].setRampLength(smoothingSamples);
+        blendRamps[static_cast<size_t>(v)].setRampLength(smoothingSamples);
+        resetVoice(v);
+    }
+}
+
+//==============================================================================
+void RingModVoiceBatch::setVoice(int voice, const RingModVoiceSettings& newSettings) noexcept
+{
+    if (voice < 0 || voice >= maxVoices)
+        return;
+
+    // The increment's pow is paid here rather than every block
+    settings[static_cast<size_t>(voice)] = newSettings;
+    targetIncrements[static_cast<size_t>(voice)] = getTargetIncrement(newSettings);
+}
+
+void RingModVoiceBatch::resetVoice(int voice) noexcept
+{
+    if (voice < 0 || voice >= maxVoices)
+        return;
+
+    const auto v = static_cast<size_t>(voice);
+    oscillators[v].reset();
+    phaseIncRamps[v].reset(targetIncrements[v]);
+    blendRamps[v].reset(getTargetBlend(settings[v]));
+}
+
+double RingModVoiceBatch::getTargetIncrement(const RingModVoiceSettings& voice) const noexcept
+{
+    return RingModEngine::rateToPhaseIncrement(voice.rate, voice.audioRange, currentSampleRate);
+}
+
+double RingModVoiceBatch::getTargetBlend(const RingModVoiceSettings& voice) noexcept
+{
+    // Bypass fades the carrier out through the blend ramp
+    return voice.bypass ? 0.0 : static_cast<double>(voice.blend);
+}
+
+//==============================================================================
+void RingModVoiceBatch::process(float* const* channels, int numVoices, int numSamples) noexcept
+{
+    processBlock(channels, numVoices, numSamples);
+}
+
+void RingModVoiceBatch::process(double* const* channels, int numVoices, int numSamples) noexcept
+{
+    processBlock(channels, numVoices, numSamples);
+}
+
+template <typename SampleType>
+void RingModVoiceBatch::processBlock(SampleType* const* channels, int numVoices, int numSamples) noexcept
+{
+    if (channels == nullptr || numVoices <= 0 || numVoices > maxVoices || numSamples <= 0)
+        return;
+
+    // Slots: voices grouped by shape, once per block
+    int counts[3] = {};
+
+    for (int v = 0; v < numVoices; ++v)
+    {
+        const auto voice = static_cast<size_t>(v);
+        ++counts[static_cast<int>(settings[voice].waveform)];
+        phaseIncRamps[voice].setTarget(targetIncrements[voice]);
+        blendRamps[voice].setTarget(getTargetBlend(settings[voice]));
+    }
+
+    waveformEnd[0] = counts[0];
+    waveformEnd[1] = counts[0] + counts[1];
+    waveformEnd[2] = numVoices;
+    int next[3] = { 0, waveformEnd[0], waveformEnd[1] };
+
+    for (int v = 0; v < numVoices; ++v)
+        slotVoice[static_cast<size_t>(next[static_cast<int>(settings[static_cast<size_t>(v)].waveform)]++)] = v;
+
+    const auto kernel = getVoiceBatchKernel<SampleType>(simdLevel, true);
+    const auto constantKernel = getVoiceBatchKernel<SampleType>(simdLevel, false);
+
+    // Segments end wherever any voice's ramp does, so every voice's slopes
+    // are constant across each one; once nothing moves, the rest of the
+    // block is one constant-parameter run
+    for (int start = 0; start < numSamples;)
+    {
+        int length = numSamples - start;
+        bool ramped = false;
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            for (const int remaining : { phaseIncRamps[static_cast<size_t>(v)].getRemainingSamples(),
+                                         blendRamps[static_cast<size_t>(v)].getRemainingSamples() })
+            {
+                if (remaining > 0)
+                {
+                    ramped = true;
+                    length = std::min(length, remaining);
+                }
+            }
+        }
+
+        loadSlots(channels, numVoices, start, ramped);
+
+        RingModVoiceBlock<SampleType> block;
+        block.channelsPerVoice = channelsPerVoice;
+        block.numVoices = numVoices;
+        block.numSamples = length;
+        std::copy(std::begin(waveformEnd), std::end(waveformEnd), block.waveformEnd);
+        block.phase = slotPhase.get();
+        block.phaseInc = slotPhaseInc.get();
+        block.phaseIncStep = slotPhaseIncStep.get();
+
+        if constexpr (std::is_same_v<SampleType, double>)
+        {
+            block.channels = slotChannelsDouble.data();
+            block.blend = slotBlendDouble.get();
+            block.blendStep = slotBlendStepDouble.get();
+            block.gains = gainsDouble.get();
+        }
+        else
+        {
+            block.channels = slotChannels.data();
+            block.blend = slotBlend.get();
+            block.blendStep = slotBlendStep.get();
+            block.gains = gains.get();
+        }
+
+        (ramped ? kernel : constantKernel)(block);
+
+        // The kernel ran on the rounded 32-bit phases; the master phases
+        // move on by the exact amount, as in the engine
+        for (int v = 0; v < numVoices; ++v)
+        {
+            const auto voice = static_cast<size_t>(v);
+            oscillators[voice].advance(length, phaseIncRamps[voice].getCurrent(), phaseIncRamps[voice].getStep());
+            phaseIncRamps[voice].advance(length);
+            blendRamps[voice].advance(length);
+        }
+
+        start += length;
+    }
+}
+
+template <typename SampleType>
+void RingModVoiceBatch::loadSlots(SampleType* const* channels, int numVoices, int position, bool ramped) noexcept
+{
+    SampleType* blends;
+    SampleType* blendSteps;
+    SampleType** slotChannelPointers;
+
+    if constexpr (std::is_same_v<SampleType, double>)
+    {
+        blends = slotBlendDouble.get();
+        blendSteps = slotBlendStepDouble.get();
+        slotChannelPointers = slotChannelsDouble.data();
+    }
+    else
+    {
+        blends = slotBlend.get();
+        blendSteps = slotBlendStep.get();
+        slotChannelPointers = slotChannels.data();
+    }
+
+    for (int slot = 0; slot < numVoices; ++slot)
+    {
+        const int voice = slotVoice[static_cast<size_t>(slot)];
+        const auto& phaseIncRamp = phaseIncRamps[static_cast<size_t>(voice)];
+        const auto& blendRamp = blendRamps[static_cast<size_t>(voice)];
+
+        slotPhase.get()[slot] = oscillators[static_cast<size_t>(voice)].getPhase();
+        slotPhaseInc.get()[slot] = static_cast<uint32_t>(std::llround(phaseIncRamp.getCurrent()));
+        slotPhaseIncStep.get()[slot] = ramped ? static_cast<int32_t>(std::llround(phaseIncRamp.getStep())) : 0;
+        blends[slot] = static_cast<SampleType>(blendRamp.getCurrent());
+        blendSteps[slot] = ramped ? static_cast<SampleType>(blendRamp.getStep()) : SampleType(0);
+
+        for (int ch = 0; ch < channelsPerVoice; ++ch)
+            slotChannelPointers[slot * channelsPerVoice + ch] = channels[voice * channelsPerVoice + ch] + position;
+    }
+}
@@ -0,0 +1,99 @@
+/*
+  DDX3216 Ring Modulator Plugin - Voice Batch
+  Many independent ring mods - one per track of a mixer, say - processed in
+  a single call. Each voice has its own carrier and settings; the hot state
+  (phases, increments, blends) is kept structure-of-arrays so one vector
+  register carries the oscillators of several voices at once.
+
+  A voice is the classic single carrier on the SIMD path's polynomial
+  shapes, with the plugin's rate range, blend, bypass and 20ms smoothing.
+  No MIDI, carrier bank, sidechain, dynamics or oversampling: those stay
+  with RingModEngine.
+*/
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "DdsOscillator.h"
+#include "ParameterRamp.h"
+#include "RingModKernels.h"
+#include "RingModSimd.h"
+
+//==============================================================================
+// One voice's settings, in the plugin's parameter units
+//==============================================================================
+struct RingModVoiceSettings
+{
+    float rate = 0.3f;                 // 0-1 across the range
+    float blend = 0.5f;                // 0 clean to 1 full modulation
+    DdsWaveform waveform = DdsWaveform::Sine;
+    bool bypass = false;               // fades out through the blend
+    bool audioRange = false;           // 20 Hz-5 kHz instead of the 0.5-20 Hz LFO
+};
+
+//==============================================================================
+class RingModVoiceBatch
+{
+public:
+    // Uses the widest kernels this build and CPU support
+    RingModVoiceBatch();
+    explicit RingModVoiceBatch(SimdLevel level);
+
+    // Not realtime-safe: sizes everything for up to maxVoices voices of
+    // channelsPerVoice channels each, in blocks of any length, and starts
+    // every voice at phase 0, settled on its settings
+    void prepare(double sampleRate, int maxVoices, int channelsPerVoice);
+
+    // Taken up at the start of the next process call, ramped as the plugin
+    // ramps. Out-of-range voices are ignored.
+    void setVoice(int voice, const RingModVoiceSettings& newSettings) noexcept;
+    const RingModVoiceSettings& getVoice(int voice) const noexcept { return settings[static_cast<size_t>(voice)]; }
+
+    // Back to phase 0, settled on the voice's settings (a track reused)
+    void resetVoice(int voice) noexcept;
+
+    // Realtime-safe. Voices [0, numVoices) are processed in place; voice v's
+    // channel c is channels[v * channelsPerVoice + c], numSamples long.
+    // Nothing happens before prepare or with more voices than prepared for.
+    void process(float* const* channels, int numVoices, int numSamples) noexcept;
+    void process(double* const* channels, int numVoices, int numSamples) noexcept;
+
+    int getMaxVoices() const noexcept { return maxVoices; }
+    int getChannelsPerVoice() const noexcept { return channelsPerVoice; }
+    SimdLevel getSimdLevel() const noexcept { return simdLevel; }
+
+private:
+    template <typename SampleType>
+    void processBlock(SampleType* const* channels, int numVoices, int numSamples) noexcept;
+
+    // Voices grouped by shape into slots (sines, triangles, squares), and
+    // the kernel's arrays filled in slot order for the segment starting at
+    // position, with slopes only while ramped
+    template <typename SampleType>
+    void loadSlots(SampleType* const* channels, int numVoices, int position, bool ramped) noexcept;
+
+    double getTargetIncrement(const RingModVoiceSettings& voice) const noexcept;
+    static double getTargetBlend(const RingModVoiceSettings& voice) noexcept;
+
+    const SimdLevel simdLevel;
+    double currentSampleRate = 48000.0;
+    int maxVoices = 0, channelsPerVoice = 1;
+    int smoothingSamples = 1;
+
+    // Per voice, in voice order. The master phases are the oscillators'
+    // 64-bit ones, as in the engine, so long renders never drift.
+    std::vector<RingModVoiceSettings> settings;
+    std::vector<double> targetIncrements;
+    std::vector<DdsOscillator> oscillators;
+    std::vector<ParameterRamp<double>> phaseIncRamps, blendRamps;
+
+    // Kernel arrays, in slot order
+    int waveformEnd[3] = {};
+    std::vector<int> slotVoice;
+    SimdAlignedBuffer<uint32_t> slotPhase, slotPhaseInc;
+    SimdAlignedBuffer<int32_t> slotPhaseIncStep;
+    SimdAlignedBuffer<float> slotBlend, slotBlendStep, gains;
+    SimdAlignedBuffer<double> slotBlendDouble, slotBlendStepDouble, gainsDouble;
+    std::vector<float*> slotChannels;
+    std::vector<double*> slotChannelsDouble;
+};
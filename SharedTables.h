@@ -0,0 +1,67 @@
+/*
+  DDX3216 Ring Modulator Plugin - Shared Tables
+  Process-wide cache of immutable DSP tables (wavetables, filter
+  coefficients, FFT and window data). The first instance to ask for a
+  table builds it; every later instance gets the same copy, so one set
+  stays cache-hot for all of them, and it is freed when the last holder
+  lets go. Used from constructors and prepareToPlay, never from the audio
+  thread.
+*/
+
+#pragma once
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <typeindex>
+
+//==============================================================================
+class SharedTables
+{
+public:
+    // Table type T for a sample rate and size (0 for either when the table
+    // doesn't depend on it), built by make() if no instance holds one
+    template <typename T, typename Builder>
+    static std::shared_ptr<const T> get(double sampleRate, int size, Builder&& make)
+    {
+        auto& cache = getCache();
+        const std::lock_guard<std::mutex> lock(cache.mutex);
+
+        const Key key { std::type_index(typeid(T)), sampleRate, size };
+
+        if (auto found = cache.entries.find(key); found != cache.entries.end())
+            if (auto existing = found->second.lock())
+                return std::static_pointer_cast<const T>(existing);
+
+        // Entries whose last holder went away
+        for (auto it = cache.entries.begin(); it != cache.entries.end();)
+            it = it->second.expired() ? cache.entries.erase(it) : std::next(it);
+
+        std::shared_ptr<const T> table = make();
+        cache.entries[key] = table;
+        return table;
+    }
+
+    // Tables that are default-constructible and depend on nothing
+    template <typename T>
+    static std::shared_ptr<const T> get()
+    {
+        return get<T>(0.0, 0, [] { return std::make_shared<const T>(); });
+    }
+
+private:
+    using Key = std::tuple<std::type_index, double, int>;
+
+    struct Cache
+    {
+        std::mutex mutex;
+        std::map<Key, std::weak_ptr<const void>> entries;
+    };
+
+    static Cache& getCache()
+    {
+        static Cache cache;
+        return cache;
+    }
+};
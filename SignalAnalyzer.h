@@ -0,0 +1,259 @@
+/*
+  DDX3216 Ring Modulator Plugin - Scope / Spectrum Analyzer
+  JUCE 8.0.11
+  The audio thread mixes its output to mono, decimates it to 48 kHz or
+  below and pushes it into a wait-free SPSC FIFO. A background thread
+  drains the FIFO, runs a Hann-windowed FFT and picks a triggered scope
+  window, and hands finished frames to the editor through a triple
+  buffer. Nothing runs, and the audio thread only checks one flag,
+  unless an editor is attached.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include "PerfMonitor.h"
+#include "SharedTables.h"
+
+//==============================================================================
+// One finished analysis, ready to draw
+//==============================================================================
+struct AnalyzerFrame
+{
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = fftSize / 2;
+    static constexpr int scopeSize = 512;
+
+    AnalyzerFrame() noexcept { spectrumDb.fill(-120.0f); }
+
+    std::array<float, scopeSize> scope {};        // output, starting at a rising zero crossing
+    std::array<float, numBins> spectrumDb {};     // magnitude per bin, dBFS
+    double sampleRate = 48000.0;                  // after decimation
+    uint64_t sequence = 0;
+};
+
+//==============================================================================
+// FFT plan and window; read-only once built, so every instance shares one
+//==============================================================================
+struct AnalyzerTables
+{
+    juce::dsp::FFT fft { AnalyzerFrame::fftOrder };
+    juce::dsp::WindowingFunction<float> window { static_cast<size_t>(AnalyzerFrame::fftSize),
+                                                 juce::dsp::WindowingFunction<float>::hann, true };
+};
+
+//==============================================================================
+class SignalAnalyzer : private juce::Thread
+{
+public:
+    SignalAnalyzer()
+        : juce::Thread("DDX Analyzer"),
+          fifo(fifoSize),
+          tables(SharedTables::get<AnalyzerTables>())
+    {
+        fifoData.resize(static_cast<size_t>(fifoSize));
+        fftData.resize(static_cast<size_t>(AnalyzerFrame::fftSize * 2));
+    }
+
+    ~SignalAnalyzer() override
+    {
+        stopThread(1000);
+    }
+
+    // Message thread. The FIFO never reallocates, so this is safe while
+    // the analyzer is running; the thread restarts its history on a change.
+    void prepare(double sampleRate) noexcept
+    {
+        const int factor = juce::jmax(1, static_cast<int>(std::ceil(sampleRate / 48000.0)));
+        decimation.store(factor);
+        decimatedRate.store(sampleRate / factor);
+    }
+
+    // Editors attach while open; the last one to go stops the thread
+    void attachViewer()
+    {
+        if (numViewers++ == 0)
+        {
+            active.store(true);
+            startThread(juce::Thread::Priority::low);
+        }
+    }
+
+    void detachViewer()
+    {
+        if (--numViewers == 0)
+        {
+            active.store(false);
+            stopThread(1000);
+        }
+    }
+
+    // Editor: returns true if a new frame arrived since the last call
+    bool getLatestFrame(AnalyzerFrame& frame) noexcept { return frames.read(frame); }
+
+    //==============================================================================
+    // Audio thread: wait-free, no allocation. Samples that don't fit in the
+    // FIFO (the analyzer thread fell behind) are dropped.
+    template <typename SampleType>
+    void push(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        if (! active.load(std::memory_order_relaxed) || numChannels <= 0)
+            return;
+
+        const int factor = decimation.load(std::memory_order_relaxed);
+        const float scale = 1.0f / static_cast<float>(numChannels * factor);
+
+        for (int start = 0; start < numSamples; start += stagingSize * factor)
+        {
+            // Boxcar-averaged decimation of the mono sum
+            int produced = 0;
+            const int end = juce::jmin(numSamples, start + stagingSize * factor);
+
+            for (int i = start; i < end; ++i)
+            {
+                float sum = 0.0f;
+                for (int ch = 0; ch < numChannels; ++ch)
+                    sum += static_cast<float>(channels[ch][i]);
+
+                accumulator += sum;
+
+                if (++accumulated >= factor)
+                {
+                    staging[static_cast<size_t>(produced++)] = accumulator * scale;
+                    accumulator = 0.0f;
+                    accumulated = 0;
+                }
+            }
+
+            const auto scope = fifo.write(juce::jmin(produced, fifo.getFreeSpace()));
+            if (scope.blockSize1 > 0)
+                std::memcpy(fifoData.data() + scope.startIndex1, staging.data(), sizeof(float) * static_cast<size_t>(scope.blockSize1));
+            if (scope.blockSize2 > 0)
+                std::memcpy(fifoData.data() + scope.startIndex2, staging.data() + scope.blockSize1, sizeof(float) * static_cast<size_t>(scope.blockSize2));
+        }
+    }
+
+private:
+    static constexpr int fifoSize = 32768;      // over a quarter second at any decimated rate
+    static constexpr int stagingSize = 256;
+    static constexpr int historySize = AnalyzerFrame::fftSize;
+    static constexpr int hopSize = AnalyzerFrame::fftSize / 2;
+
+    //==============================================================================
+    void run() override
+    {
+        std::vector<float> incoming(static_cast<size_t>(fifoSize));
+        double rate = 0.0;
+
+        while (! threadShouldExit())
+        {
+            // New sample rate: old history is meaningless
+            const double currentRate = decimatedRate.load();
+            if (currentRate != rate)
+            {
+                rate = currentRate;
+                std::fill(history.begin(), history.end(), 0.0f);
+                newSamples = 0;
+            }
+
+            const int available = fifo.getNumReady();
+            if (available > 0)
+            {
+                const auto scope = fifo.read(available);
+                std::memcpy(incoming.data(), fifoData.data() + scope.startIndex1, sizeof(float) * static_cast<size_t>(scope.blockSize1));
+                std::memcpy(incoming.data() + scope.blockSize1, fifoData.data() + scope.startIndex2, sizeof(float) * static_cast<size_t>(scope.blockSize2));
+                append(incoming.data(), available);
+            }
+
+            // At most one frame per wake-up, from the newest samples
+            if (newSamples >= hopSize)
+            {
+                analyse(rate);
+                newSamples = 0;
+            }
+
+            wait(10);
+        }
+    }
+
+    void append(const float* data, int numSamples) noexcept
+    {
+        if (numSamples >= historySize)
+        {
+            std::copy(data + numSamples - historySize, data + numSamples, history.begin());
+        }
+        else
+        {
+            std::copy(history.begin() + numSamples, history.end(), history.begin());
+            std::copy(data, data + numSamples, history.end() - numSamples);
+        }
+
+        newSamples += numSamples;
+    }
+
+    void analyse(double rate)
+    {
+        // Spectrum: peaks show at once, then fall halfway per frame
+        std::fill(fftData.begin(), fftData.end(), 0.0f);
+        std::copy(history.begin(), history.end(), fftData.begin());
+        tables->window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(AnalyzerFrame::fftSize));
+        tables->fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+        const float norm = 2.0f / static_cast<float>(AnalyzerFrame::fftSize);
+        for (int bin = 0; bin < AnalyzerFrame::numBins; ++bin)
+        {
+            const float db = juce::Decibels::gainToDecibels(fftData[static_cast<size_t>(bin)] * norm, -120.0f);
+            auto& smoothed = working.spectrumDb[static_cast<size_t>(bin)];
+            smoothed = juce::jmax(db, smoothed - 0.5f * (smoothed - db));
+        }
+
+        // Scope: latest window that starts on a rising zero crossing, so
+        // periodic signals stand still
+        const int latest = historySize - AnalyzerFrame::scopeSize;
+        int start = latest;
+        for (int i = latest; i > 0; --i)
+        {
+            if (history[static_cast<size_t>(i - 1)] < 0.0f && history[static_cast<size_t>(i)] >= 0.0f)
+            {
+                start = i;
+                break;
+            }
+        }
+
+        std::copy(history.begin() + start, history.begin() + start + AnalyzerFrame::scopeSize, working.scope.begin());
+        working.sampleRate = rate;
+        ++working.sequence;
+        frames.write(working);
+    }
+
+    // Shared with the audio thread
+    juce::AbstractFifo fifo;
+    std::vector<float> fifoData;
+    std::atomic<bool> active { false };
+    std::atomic<int> decimation { 1 };
+    std::atomic<double> decimatedRate { 48000.0 };
+
+    // Audio thread only
+    std::array<float, stagingSize> staging {};
+    float accumulator = 0.0f;
+    int accumulated = 0;
+
+    // Analyzer thread only
+    std::array<float, historySize> history {};
+    int newSamples = 0;
+    std::shared_ptr<const AnalyzerTables> tables;
+    std::vector<float> fftData;
+    AnalyzerFrame working;
+
+    // Analyzer thread to editor
+    TripleBuffer<AnalyzerFrame> frames;
+
+    // Message thread only
+    int numViewers = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SignalAnalyzer)
+};
@@ -0,0 +1,465 @@
+/*
+  DDX3216 Ring Modulator Plugin - Offline Batch Renderer
+  JUCE 8.0.11
+  Pushes WAV files through DdxRingModAudioProcessor (non-realtime, so the
+  render oversampling setting applies) on every core. Each file is cut
+  into block-aligned chunks; a worker seeks its own processor instance to
+  the chunk start (minus a short pre-roll that refills the oversampling
+  filters) and renders it, so with dynamics off the joined output is
+  bit-identical to one straight pass. Chunks are handed out through a work-stealing pool and
+  written in order, latency compensated, as WAV at the input's bit depth.
+
+  With dynamics on, a seek can't rebuild the envelope or the phase it
+  modulated, so chunks are rendered one at a time, in order, on a single
+  instance that is never seeked (writing still overlaps rendering). The
+  output is then that of one straight pass, without the parallelism.
+
+  Build as a JUCE console app (juce_audio_formats, juce_audio_processors,
+  juce_dsp) compiling this file together with the plugin sources:
+  PluginProcessor.cpp, PluginEditor.cpp, RingModEngine.cpp, RingModKernels*.cpp
+
+  Usage: RingModBatchRender [--threads N] [--chunk seconds] [--block samples]
+                            [--set paramID=value ...] --output-dir dir
+                            input.wav [input.wav ...]
+*/
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    //==============================================================================
+    // Each worker drains its own deque from the front and, once it is empty,
+    // steals from the back of the others. Tasks here are whole chunks (a few
+    // seconds of audio), so a mutex per deque costs nothing measurable.
+    //==============================================================================
+    class WorkStealingPool
+    {
+    public:
+        using Task = std::function<void(int worker, int task)>;
+
+        WorkStealingPool(int numWorkers, Task taskToRun)
+            : run(std::move(taskToRun))
+        {
+            for (int w = 0; w < numWorkers; ++w)
+                queues.push_back(std::make_unique<Queue>());
+
+            for (int w = 0; w < numWorkers; ++w)
+                threads.emplace_back([this, w] { workerLoop(w); });
+        }
+
+        ~WorkStealingPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(stateLock);
+                quit = true;
+            }
+
+            wake.notify_all();
+
+            for (auto& thread : threads)
+                thread.join();
+        }
+
+        int getNumWorkers() const noexcept { return static_cast<int>(queues.size()); }
+
+        // Tasks [first, last) go out in contiguous runs, one run per worker
+        void submit(int first, int last)
+        {
+            const int numWorkers = getNumWorkers();
+            const int count = last - first;
+
+            for (int w = 0; w < numWorkers; ++w)
+            {
+                std::lock_guard<std::mutex> lock(queues[static_cast<size_t>(w)]->lock);
+
+                for (int t = first + count * w / numWorkers; t < first + count * (w + 1) / numWorkers; ++t)
+                    queues[static_cast<size_t>(w)]->tasks.push_back(t);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(stateLock);
+                queued += count;
+                pending += count;
+            }
+
+            wake.notify_all();
+        }
+
+        // Blocks until everything submitted so far has run
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(stateLock);
+            idle.wait(lock, [this] { return pending == 0; });
+        }
+
+    private:
+        struct Queue
+        {
+            std::mutex lock;
+            std::deque<int> tasks;
+        };
+
+        // Only called with a task reserved, so one of the deques has it
+        int take(int worker)
+        {
+            const int numWorkers = getNumWorkers();
+
+            for (int i = 0; i < numWorkers; ++i)
+            {
+                auto& queue = *queues[static_cast<size_t>((worker + i) % numWorkers)];
+                std::lock_guard<std::mutex> lock(queue.lock);
+
+                if (queue.tasks.empty())
+                    continue;
+
+                // Own work from the front, stolen work from the back
+                const int task = i == 0 ? queue.tasks.front() : queue.tasks.back();
+
+                if (i == 0)
+                    queue.tasks.pop_front();
+                else
+                    queue.tasks.pop_back();
+
+                return task;
+            }
+
+            jassertfalse;
+            return -1;
+        }
+
+        void workerLoop(int worker)
+        {
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(stateLock);
+                    wake.wait(lock, [this] { return quit || queued > 0; });
+
+                    if (quit)
+                        return;
+
+                    --queued;
+                }
+
+                const int task = take(worker);
+                if (task >= 0)
+                    run(worker, task);
+
+                std::lock_guard<std::mutex> lock(stateLock);
+                if (--pending == 0)
+                    idle.notify_all();
+            }
+        }
+
+        Task run;
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+
+        std::mutex stateLock;
+        std::condition_variable wake, idle;
+        int queued = 0;     // submitted, not yet taken by a worker
+        int pending = 0;    // submitted, not yet finished
+        bool quit = false;
+    };
+
+    //==============================================================================
+    struct Settings
+    {
+        int numThreads = juce::jmax(1, juce::SystemStats::getNumCpus());
+        double chunkSeconds = 2.0;
+        int blockSize = 512;
+        juce::StringPairArray parameters;   // paramID -> plain value
+        juce::File outputDir;
+    };
+
+    // Enough to refill every oversampling filter's history (43 samples of
+    // latency at 8x, spread over a little under twice that of taps)
+    constexpr int preRollSamples = 256;
+
+    juce::AudioChannelSet channelSetFor(int numChannels)
+    {
+        switch (numChannels)
+        {
+        case 1:  return juce::AudioChannelSet::mono();
+        case 2:  return juce::AudioChannelSet::stereo();
+        default: return juce::AudioChannelSet::discreteChannels(numChannels);
+        }
+    }
+
+    std::unique_ptr<DdxRingModAudioProcessor> createProcessor(const Settings& settings, int numChannels, double sampleRate)
+    {
+        auto processor = std::make_unique<DdxRingModAudioProcessor>();
+
+        auto layout = processor->getBusesLayout();
+        layout.inputBuses.getReference(0) = channelSetFor(numChannels);
+        layout.outputBuses.getReference(0) = channelSetFor(numChannels);
+
+        if (! processor->setBusesLayout(layout))
+            return nullptr;
+
+        auto& apvts = processor->getAPVTS();
+        for (auto& id : settings.parameters.getAllKeys())
+            if (auto* param = apvts.getParameter(id))
+                param->setValueNotifyingHost(param->convertTo0to1(settings.parameters[id].getFloatValue()));
+
+        processor->setNonRealtime(true);
+        processor->setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+        processor->prepareToPlay(sampleRate, settings.blockSize);
+        return processor;
+    }
+
+    //==============================================================================
+    // Reads straight out of the mapped file where the format allows it; the
+    // streamed fallback is shared between workers behind a lock
+    //==============================================================================
+    class SourceReader
+    {
+    public:
+        explicit SourceReader(const juce::File& file)
+        {
+            juce::WavAudioFormat wav;
+            mapped.reset(wav.createMemoryMappedReader(file));
+
+            if (mapped != nullptr && mapped->mapEntireFile())
+                return;
+
+            mapped.reset();
+            formatManager.registerBasicFormats();
+            streamed.reset(formatManager.createReaderFor(file));
+        }
+
+        juce::AudioFormatReader* get() const noexcept
+        {
+            return mapped != nullptr ? static_cast<juce::AudioFormatReader*>(mapped.get()) : streamed.get();
+        }
+
+        bool isMapped() const noexcept { return mapped != nullptr; }
+
+        // Zero-fills past the end of the file
+        void read(float* const* channels, int numChannels, juce::int64 start, int numSamples)
+        {
+            if (mapped != nullptr)
+            {
+                mapped->read(channels, numChannels, start, numSamples);
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(streamLock);
+            streamed->read(channels, numChannels, start, numSamples);
+        }
+
+    private:
+        juce::AudioFormatManager formatManager;
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped;
+        std::unique_ptr<juce::AudioFormatReader> streamed;
+        std::mutex streamLock;
+    };
+
+    //==============================================================================
+    bool renderFile(const juce::File& input, const Settings& settings, WorkStealingPool::Task& poolTask,
+                    WorkStealingPool& pool)
+    {
+        SourceReader source(input);
+        auto* reader = source.get();
+
+        if (reader == nullptr)
+        {
+            std::cerr << "Can't read " << input.getFullPathName() << std::endl;
+            return false;
+        }
+
+        const int numChannels = static_cast<int>(reader->numChannels);
+        const double sampleRate = reader->sampleRate;
+        const juce::int64 length = reader->lengthInSamples;
+        const int numWorkers = pool.getNumWorkers();
+
+        // One processor per worker, all prepared identically; just the one
+        // when chunks have to run in order
+        std::vector<std::unique_ptr<DdxRingModAudioProcessor>> processors;
+        bool sequential = false;
+
+        for (int w = 0; w < (sequential ? 1 : numWorkers); ++w)
+        {
+            processors.push_back(createProcessor(settings, numChannels, sampleRate));
+
+            if (processors.back() == nullptr)
+            {
+                std::cerr << "Unsupported channel count in " << input.getFullPathName() << std::endl;
+                return false;
+            }
+
+            if (auto* dynamics = processors.front()->getAPVTS().getRawParameterValue("dynamics"))
+                sequential = dynamics->load() > 0.5f;
+        }
+
+        // Rendered position p lands at output p - latency; render latency
+        // samples past the end so the tail isn't cut off
+        const int latency = processors.front()->getLatencySamples();
+        const juce::int64 renderLength = length + latency;
+
+        const int blockSize = settings.blockSize;
+        const int chunkSize = juce::jmax(1, juce::roundToInt(settings.chunkSeconds * sampleRate / blockSize)) * blockSize;
+        const int numChunks = static_cast<int>((renderLength + chunkSize - 1) / chunkSize);
+        const int preRoll = sequential ? 0 : (preRollSamples + blockSize - 1) / blockSize * blockSize;
+
+        // Two windows of slots: one being rendered while the other is written.
+        // Two chunks per worker leaves room to steal without holding much
+        // of the file in memory. In order, a window is one chunk, so only
+        // one is ever rendering.
+        const int window = sequential ? 1 : numWorkers * 2;
+        std::vector<juce::AudioBuffer<float>> slots(static_cast<size_t>(window * 2));
+        for (auto& slot : slots)
+            slot.setSize(numChannels, preRoll + chunkSize);
+
+        poolTask = [&](int worker, int chunk)
+        {
+            auto& processor = *processors[sequential ? 0 : static_cast<size_t>(worker)];
+            auto& slot = slots[static_cast<size_t>(chunk % (window * 2))];
+
+            const juce::int64 start = static_cast<juce::int64>(chunk) * chunkSize;
+            const int lead = start > 0 ? preRoll : 0;
+            const int total = lead + static_cast<int>(juce::jmin<juce::int64>(chunkSize, renderLength - start));
+
+            source.read(slot.getArrayOfWritePointers(), numChannels, start - lead, total);
+
+            // In order, the processor simply carries on from the last chunk
+            if (! sequential)
+                processor.seekTo(start - lead);
+
+            juce::MidiBuffer midi;
+            for (int offset = 0; offset < total; offset += blockSize)
+            {
+                juce::AudioBuffer<float> block(slot.getArrayOfWritePointers(), numChannels, offset,
+                                               juce::jmin(blockSize, total - offset));
+                processor.processBlock(block, midi);
+            }
+        };
+
+        // Same format as the input
+        const auto outputFile = settings.outputDir.getChildFile(input.getFileNameWithoutExtension() + ".wav");
+        outputFile.deleteFile();
+
+        juce::WavAudioFormat wav;
+        auto stream = std::make_unique<juce::FileOutputStream>(outputFile);
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            wav.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+                                static_cast<int>(reader->bitsPerSample), {}, 0));
+
+        // The writer owns the stream only once it exists
+        if (writer != nullptr)
+            stream.release();
+
+        if (writer == nullptr)
+        {
+            std::cerr << "Can't write " << outputFile.getFullPathName() << std::endl;
+            return false;
+        }
+
+        // Writes straight out of the slot the chunk was rendered into
+        auto writeChunk = [&](int chunk)
+        {
+            const auto& slot = slots[static_cast<size_t>(chunk % (window * 2))];
+            const juce::int64 start = static_cast<juce::int64>(chunk) * chunkSize;
+            const int lead = start > 0 ? preRoll : 0;
+
+            // Output range of this chunk, shifted back by the latency
+            const juce::int64 outStart = juce::jmax<juce::int64>(0, start - latency);
+            const juce::int64 outEnd = juce::jmin(length, start + chunkSize - latency);
+
+            if (outEnd > outStart)
+                writer->writeFromAudioSampleBuffer(slot, lead + static_cast<int>(outStart - (start - latency)),
+                                                   static_cast<int>(outEnd - outStart));
+        };
+
+        const auto started = std::chrono::steady_clock::now();
+
+        pool.submit(0, juce::jmin(window, numChunks));
+        pool.wait();
+
+        for (int first = 0; first < numChunks; first += window)
+        {
+            const int next = first + window;
+            if (next < numChunks)
+                pool.submit(next, juce::jmin(next + window, numChunks));
+
+            for (int chunk = first; chunk < juce::jmin(next, numChunks); ++chunk)
+                writeChunk(chunk);
+
+            pool.wait();
+        }
+
+        writer.reset();
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        const double audioSeconds = static_cast<double>(length) / sampleRate;
+
+        std::cout << input.getFileName() << ": " << numChannels << " ch, "
+                  << juce::String(audioSeconds, 1) << " s in " << juce::String(seconds, 2) << " s ("
+                  << juce::String(seconds > 0.0 ? audioSeconds / seconds : 0.0, 1) << "x realtime, "
+                  << numChunks << (sequential ? " chunks in order, " : " chunks, ")
+                  << (source.isMapped() ? "mapped" : "streamed") << ")"
+                  << std::endl;
+        return true;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    Settings settings;
+    juce::Array<juce::File> inputs;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--threads" && hasValue)
+            settings.numThreads = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--chunk" && hasValue)
+            settings.chunkSeconds = juce::jmax(0.01, juce::String(argv[++i]).getDoubleValue());
+        else if (arg == "--block" && hasValue)
+            settings.blockSize = juce::jlimit(16, 65536, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--set" && hasValue)
+        {
+            const juce::String assignment(argv[++i]);
+            settings.parameters.set(assignment.upToFirstOccurrenceOf("=", false, false),
+                                    assignment.fromFirstOccurrenceOf("=", false, false));
+        }
+        else if (arg == "--output-dir" && hasValue)
+            settings.outputDir = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else
+            inputs.add(juce::File::getCurrentWorkingDirectory().getChildFile(arg));
+    }
+
+    if (inputs.isEmpty() || settings.outputDir == juce::File())
+    {
+        std::cerr << "Usage: RingModBatchRender [--threads N] [--chunk seconds] [--block samples]\n"
+                     "                          [--set paramID=value ...] --output-dir dir input.wav ..."
+                  << std::endl;
+        return 1;
+    }
+
+    settings.outputDir.createDirectory();
+
+    WorkStealingPool::Task task;
+    WorkStealingPool pool(settings.numThreads, [&task](int worker, int chunk) { task(worker, chunk); });
+
+    int failures = 0;
+    for (auto& input : inputs)
+        if (! renderFile(input, settings, task, pool))
+            ++failures;
+
+    return failures == 0 ? 0 : 1;
+}
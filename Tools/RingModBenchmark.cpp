@@ -0,0 +1,345 @@
+/*
+  DDX3216 Ring Modulator Plugin - Headless Benchmark
+  JUCE 8.0.11
+  Drives DdxRingModAudioProcessor::processBlock (no editor) across block
+  sizes, sample rates, waveforms, channel layouts, scalar/SIMD and
+  float/double precision, and prints ns/sample, throughput and run-to-run
+  variance as JSON. --midi N drives the carrier from N note and pitch-bend
+  events per block, evenly spaced, to compare against static parameters;
+  --dynamics turns on the input envelope follower; --emulation 1 or 2
+  replaces the scalar/SIMD pair with the SHARC 32-bit or 40-bit emulation.
+
+  Build as a JUCE console app (juce_audio_processors, juce_dsp) compiling
+  this file together with the plugin sources:
+  PluginProcessor.cpp, PluginEditor.cpp, RingModEngine.cpp, RingModKernels*.cpp
+
+  Usage: RingModBenchmark [--quick] [--spread 0-1] [--carriers 1-16] [--midi events] [--dynamics] [--emulation 0-2] [--output results.json]
+*/
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+namespace
+{
+    //==============================================================================
+    struct BenchCase
+    {
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+        int waveform = 0;               // index into the "waveform" choice
+        int numInputChannels = 2;       // main bus: mono in, stereo out, or N in, N out
+        int numOutputChannels = 2;
+        bool simd = false;
+        bool doublePrecision = false;
+        float spread = 0.0f;
+        int carriers = 1;
+        int midiEvents = 0;             // per block; 0 leaves MIDI control off
+        bool dynamics = false;
+        int emulation = 0;              // index into the "emulation" choice
+    };
+
+    struct BenchResult
+    {
+        BenchCase config;
+        juce::Array<double> nsPerSample;    // one entry per repetition
+        double harnessNsPerSample = 0.0;    // input refill cost, subtracted out
+    };
+
+    struct Settings
+    {
+        int repetitions = 9;
+        int64_t samplesPerRepetition = 1 << 18;
+        int warmupBlocks = 64;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    //==============================================================================
+    void setParameter(juce::AudioProcessorValueTreeState& apvts, const juce::String& id, float plainValue)
+    {
+        if (auto* param = apvts.getParameter(id))
+            param->setValueNotifyingHost(param->convertTo0to1(plainValue));
+    }
+
+    template <typename SampleType>
+    void fillNoise(juce::AudioBuffer<SampleType>& buffer, uint32_t seed)
+    {
+        std::minstd_rand rng(seed);
+        std::uniform_real_distribution<SampleType> dist(SampleType(-0.5), SampleType(0.5));
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, dist(rng));
+    }
+
+    juce::AudioChannelSet channelSetFor(int numChannels)
+    {
+        switch (numChannels)
+        {
+        case 1:  return juce::AudioChannelSet::mono();
+        case 2:  return juce::AudioChannelSet::stereo();
+        case 6:  return juce::AudioChannelSet::create5point1();
+        default: return juce::AudioChannelSet::discreteChannels(numChannels);
+        }
+    }
+
+    juce::String describeLayout(const BenchCase& config)
+    {
+        if (config.numInputChannels != config.numOutputChannels)
+            return channelSetFor(config.numInputChannels).getDescription() + "->"
+                 + channelSetFor(config.numOutputChannels).getDescription();
+
+        return channelSetFor(config.numOutputChannels).getDescription();
+    }
+
+    //==============================================================================
+    // Copies a fresh input block in before every processBlock so signal-dependent
+    // paths always see real audio; the copy cost is measured and removed.
+    template <typename SampleType>
+    double timeRun(DdxRingModAudioProcessor* processor, const juce::AudioBuffer<SampleType>& source,
+                   juce::AudioBuffer<SampleType>& work, juce::MidiBuffer& midi, int64_t totalSamples)
+    {
+        const int blockSize = work.getNumSamples();
+        const int sourceBlocks = source.getNumSamples() / blockSize;
+        const int64_t numBlocks = juce::jmax<int64_t>(1, totalSamples / blockSize);
+
+        const auto start = Clock::now();
+
+        for (int64_t b = 0; b < numBlocks; ++b)
+        {
+            const int offset = static_cast<int>(b % sourceBlocks) * blockSize;
+
+            for (int ch = 0; ch < work.getNumChannels(); ++ch)
+                work.copyFrom(ch, 0, source, ch, offset, blockSize);
+
+            if (processor != nullptr)
+                processor->processBlock(work, midi);
+        }
+
+        const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        return elapsed / static_cast<double>(numBlocks * blockSize);
+    }
+
+    template <typename SampleType>
+    BenchResult runCase(const BenchCase& config, const Settings& settings)
+    {
+        BenchResult result;
+        result.config = config;
+
+        DdxRingModAudioProcessor processor;
+        processor.setProcessingPrecision(config.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                : juce::AudioProcessor::singlePrecision);
+
+        auto layout = processor.getBusesLayout();
+        layout.inputBuses.getReference(0) = channelSetFor(config.numInputChannels);
+        layout.outputBuses.getReference(0) = channelSetFor(config.numOutputChannels);
+        processor.setBusesLayout(layout);
+
+        auto& apvts = processor.getAPVTS();
+        setParameter(apvts, "rate", 0.3f);
+        setParameter(apvts, "blend", 0.5f);
+        setParameter(apvts, "waveform", static_cast<float>(config.waveform));
+        setParameter(apvts, "bypass", 0.0f);
+        setParameter(apvts, "simd", config.simd ? 1.0f : 0.0f);
+        setParameter(apvts, "spread", config.spread);
+        setParameter(apvts, "carriers", static_cast<float>(config.carriers));
+        setParameter(apvts, "midi", config.midiEvents > 0 ? 1.0f : 0.0f);
+        setParameter(apvts, "dynamics", config.dynamics ? 1.0f : 0.0f);
+        setParameter(apvts, "emulation", static_cast<float>(config.emulation));
+
+        const int numChannels = juce::jmax(processor.getTotalNumInputChannels(),
+                                           processor.getTotalNumOutputChannels());
+
+        processor.setRateAndBufferSizeDetails(config.sampleRate, config.blockSize);
+        processor.prepareToPlay(config.sampleRate, config.blockSize);
+
+        // A few seconds of noise, cycled through block by block
+        const int sourceBlocks = juce::jmax(1, static_cast<int>(config.sampleRate * 2.0) / config.blockSize);
+        juce::AudioBuffer<SampleType> source(numChannels, sourceBlocks * config.blockSize);
+        juce::AudioBuffer<SampleType> work(numChannels, config.blockSize);
+        juce::MidiBuffer midi;
+        fillNoise(source, 0x5eed);
+
+        // Same events every block: notes walking up two octaves, with a
+        // bend between each, so every event retunes the carrier
+        for (int e = 0; e < config.midiEvents; ++e)
+        {
+            const int position = static_cast<int>(static_cast<int64_t>(e) * config.blockSize / config.midiEvents);
+
+            if (e % 2 == 0)
+                midi.addEvent(juce::MidiMessage::noteOn(1, 48 + (e / 2) % 24, 0.8f), position);
+            else
+                midi.addEvent(juce::MidiMessage::pitchWheel(1, (e * 1031) % 16384), position);
+        }
+
+        timeRun(&processor, source, work, midi, static_cast<int64_t>(settings.warmupBlocks) * config.blockSize);
+
+        result.harnessNsPerSample = timeRun(nullptr, source, work, midi, settings.samplesPerRepetition);
+
+        for (int rep = 0; rep < settings.repetitions; ++rep)
+        {
+            const double ns = timeRun(&processor, source, work, midi, settings.samplesPerRepetition);
+            result.nsPerSample.add(juce::jmax(0.0, ns - result.harnessNsPerSample));
+        }
+
+        processor.releaseResources();
+        return result;
+    }
+
+    //==============================================================================
+    juce::var toJson(const BenchResult& result)
+    {
+        auto values = result.nsPerSample;
+        values.sort();
+
+        const int n = values.size();
+        double sum = 0.0;
+        for (auto v : values)
+            sum += v;
+
+        const double mean = sum / n;
+        double variance = 0.0;
+        for (auto v : values)
+            variance += (v - mean) * (v - mean);
+        variance /= juce::jmax(1, n - 1);
+
+        const double median = values[n / 2];
+
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty("blockSize", result.config.blockSize);
+        obj->setProperty("sampleRate", result.config.sampleRate);
+        obj->setProperty("waveform", juce::StringArray{ "Sine", "Triangle", "Square" }[result.config.waveform]);
+        obj->setProperty("layout", describeLayout(result.config));
+        obj->setProperty("numChannels", result.config.numOutputChannels);
+        obj->setProperty("spread", result.config.spread);
+        obj->setProperty("carriers", result.config.carriers);
+        obj->setProperty("midiEventsPerBlock", result.config.midiEvents);
+        obj->setProperty("dynamics", result.config.dynamics);
+        obj->setProperty("mode", result.config.emulation == 1 ? "sharc32"
+                               : result.config.emulation == 2 ? "sharc40"
+                               : result.config.simd ? "simd" : "scalar");
+        obj->setProperty("precision", result.config.doublePrecision ? "double" : "float");
+        obj->setProperty("nsPerSampleMedian", median);
+        obj->setProperty("nsPerSampleMean", mean);
+        obj->setProperty("nsPerSampleMin", values.getFirst());
+        obj->setProperty("nsPerSampleMax", values.getLast());
+        obj->setProperty("nsPerSampleStdDev", std::sqrt(variance));
+        obj->setProperty("coefficientOfVariation", mean > 0.0 ? std::sqrt(variance) / mean : 0.0);
+        obj->setProperty("megaSamplesPerSecond", median > 0.0 ? 1.0e3 / median : 0.0);
+        obj->setProperty("realtimeFactor", median > 0.0 ? 1.0e9 / (median * result.config.sampleRate) : 0.0);
+        obj->setProperty("harnessNsPerSample", result.harnessNsPerSample);
+        return juce::var(obj);
+    }
+
+    juce::var describeMachine(const DdxRingModAudioProcessor& processor)
+    {
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty("cpu", juce::SystemStats::getCpuModel());
+        obj->setProperty("numCpus", juce::SystemStats::getNumCpus());
+        obj->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        obj->setProperty("simdKernel", processor.getSimdKernelName());
+        obj->setProperty("juceVersion", juce::SystemStats::getJUCEVersion());
+        return juce::var(obj);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    const bool quick = args.contains("--quick");
+    const int outputIndex = args.indexOf("--output");
+    const juce::File outputFile = outputIndex >= 0 && outputIndex + 1 < args.size()
+                                    ? juce::File::getCurrentWorkingDirectory().getChildFile(args[outputIndex + 1])
+                                    : juce::File();
+    const int spreadIndex = args.indexOf("--spread");
+    const float spread = spreadIndex >= 0 && spreadIndex + 1 < args.size()
+                           ? juce::jlimit(0.0f, 1.0f, args[spreadIndex + 1].getFloatValue())
+                           : 0.0f;
+    const int carriersIndex = args.indexOf("--carriers");
+    const int carriers = carriersIndex >= 0 && carriersIndex + 1 < args.size()
+                           ? juce::jlimit(1, CarrierBank::maxCarriers, args[carriersIndex + 1].getIntValue())
+                           : 1;
+    const int midiIndex = args.indexOf("--midi");
+    const int midiEvents = midiIndex >= 0 && midiIndex + 1 < args.size()
+                             ? juce::jmax(0, args[midiIndex + 1].getIntValue())
+                             : 0;
+    const bool dynamics = args.contains("--dynamics");
+    const int emulationIndex = args.indexOf("--emulation");
+    const int emulation = emulationIndex >= 0 && emulationIndex + 1 < args.size()
+                            ? juce::jlimit(0, 2, args[emulationIndex + 1].getIntValue())
+                            : 0;
+
+    Settings settings;
+    if (quick)
+    {
+        settings.repetitions = 5;
+        settings.samplesPerRepetition = 1 << 16;
+    }
+
+    const juce::Array<int> blockSizes = quick ? juce::Array<int>{ 1, 63, 512, 4096 }
+                                              : juce::Array<int>{ 1, 2, 7, 32, 63, 64, 127, 256, 480, 512,
+                                                                  1000, 1024, 2048, 4095, 4096, 8192 };
+    const juce::Array<double> sampleRates = quick ? juce::Array<double>{ 48000.0 }
+                                                  : juce::Array<double>{ 44100.0, 48000.0, 96000.0, 192000.0 };
+
+    // { inputs, outputs }: mono->stereo, stereo, 5.1 and a 16-channel discrete bus
+    const int layouts[][2] = { { 1, 2 }, { 2, 2 }, { 6, 6 }, { 16, 16 } };
+
+    juce::Array<juce::var> results;
+
+    for (auto sampleRate : sampleRates)
+        for (auto blockSize : blockSizes)
+            for (int waveform = 0; waveform < 3; ++waveform)
+                for (const auto& channels : layouts)
+                    for (bool simd : { false, true })
+                        for (bool doublePrecision : { false, true })
+                        {
+                            // Emulation ignores the SIMD switch
+                            if (simd && emulation > 0)
+                                continue;
+
+                            BenchCase config;
+                            config.blockSize = blockSize;
+                            config.sampleRate = sampleRate;
+                            config.waveform = waveform;
+                            config.numInputChannels = channels[0];
+                            config.numOutputChannels = channels[1];
+                            config.simd = simd;
+                            config.doublePrecision = doublePrecision;
+                            config.spread = spread;
+                            config.carriers = carriers;
+                            config.midiEvents = midiEvents;
+                            config.dynamics = dynamics;
+                            config.emulation = emulation;
+
+                            results.add(toJson(doublePrecision ? runCase<double>(config, settings)
+                                                               : runCase<float>(config, settings)));
+                        }
+
+    DdxRingModAudioProcessor reference;
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("benchmark", "DdxRingModAudioProcessor::processBlock");
+    report->setProperty("machine", describeMachine(reference));
+    report->setProperty("repetitions", settings.repetitions);
+    report->setProperty("samplesPerRepetition", static_cast<juce::int64>(settings.samplesPerRepetition));
+    report->setProperty("results", results);
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (outputFile != juce::File())
+        return outputFile.replaceWithText(json) ? 0 : 1;
+
+    std::cout << json << std::endl;
+    return 0;
+}
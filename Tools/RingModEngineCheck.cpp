@@ -0,0 +1,500 @@
+/*
+  DDX3216 Ring Modulator Plugin - Engine Consistency Check
+  Renders the same input through RingModEngine in different host block
+  sizes and fails if the joined outputs differ by more than rounding:
+  dynamics, the carrier bank, oversampling and the mixed-out and silent
+  fast paths included, so nothing inside may depend on where a host
+  happens to split its buffers. Also checks the SHARC emulation's
+  arithmetic (rounding ties, flush to zero, overflow) and that its output
+  is bit-identical on every instruction set, and that the C API ignores
+  NaN and infinite parameter values.
+
+  Needs no JUCE: build as a plain console app compiling this file together
+  with the engine library sources listed in RingModEngine.h.
+
+  Usage: RingModEngineCheck
+  Exit code 0 if every check passed, 1 otherwise.
+*/
+
+#include "../RingModCApi.h"
+#include "../RingModEngine.h"
+#include "../RingModKernelsImpl.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    //==============================================================================
+    struct CheckConfig
+    {
+        const char* name;
+        RingModSettings settings;
+        RingModSettings laterSettings;      // from switchSample on
+        int switchSample;
+    };
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels = 2;
+    constexpr int renderLength = 96000;
+
+    // Every block size tried divides this, so settings switched here reach
+    // the engine at the same sample whatever the split
+    constexpr int commonBoundary = 37 * 1024;
+
+    constexpr double tolerance = 1.0e-5;
+
+    // Noise bursts at loud and quiet levels with stretches of silence, so
+    // the envelope follower attacks, releases and sees the silent path
+    std::vector<std::vector<float>> makeInput()
+    {
+        std::minstd_rand rng(0x5eed);
+        std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+        std::vector<std::vector<float>> input(numChannels, std::vector<float>(renderLength));
+
+        for (int i = 0; i < renderLength; ++i)
+        {
+            const int section = (i / 3000) % 4;
+            const float level = section == 0 ? 0.8f : section == 1 ? 0.02f : section == 2 ? 0.3f : 0.0f;
+
+            for (auto& channel : input)
+                channel[static_cast<size_t>(i)] = level * noise(rng);
+        }
+
+        return input;
+    }
+
+    std::vector<std::vector<float>> render(const CheckConfig& config, const std::vector<std::vector<float>>& input,
+                                           int blockSize, SimdLevel level = getSupportedSimdLevel())
+    {
+        auto output = input;
+        RingModEngine engine(level);
+        engine.setSettings(config.settings);
+        engine.prepare(sampleRate, blockSize, numChannels, 1, false);
+
+        std::vector<float*> channels(numChannels);
+
+        for (int start = 0; start < renderLength; start += blockSize)
+        {
+            const int length = std::min(blockSize, renderLength - start);
+
+            if (start >= config.switchSample)
+                engine.setSettings(config.laterSettings);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                channels[static_cast<size_t>(ch)] = output[static_cast<size_t>(ch)].data() + start;
+
+            RingModIO<float> io;
+            io.channels = channels.data();
+            io.numInputs = io.numOutputs = numChannels;
+            io.numSamples = length;
+            engine.process(io);
+        }
+
+        return output;
+    }
+
+    double maxDifference(const std::vector<std::vector<float>>& a, const std::vector<std::vector<float>>& b)
+    {
+        double result = 0.0;
+
+        for (size_t ch = 0; ch < a.size(); ++ch)
+        {
+            for (size_t i = 0; i < a[ch].size(); ++i)
+            {
+                // NaN would compare its way out of the maximum
+                const double difference = std::abs(static_cast<double>(a[ch][i]) - b[ch][i]);
+                if (! std::isfinite(difference))
+                    return HUGE_VAL;
+
+                result = std::max(result, difference);
+            }
+        }
+
+        return result;
+    }
+
+    //==============================================================================
+    // One SHARC add or multiply on every lane of Isa; the lanes must agree
+    bool sameBits(double a, double b)
+    {
+        return std::memcmp(&a, &b, sizeof(double)) == 0;
+    }
+
+    template <typename Isa, bool Extended>
+    double sharcOp(bool multiply, double a, double b)
+    {
+        using Sharc = SharcArithmetic<Isa, Extended>;
+        const auto result = multiply ? Sharc::mul(Isa::set(a), Isa::set(b)) : Sharc::add(Isa::set(a), Isa::set(b));
+
+        double lanes[Isa::width];
+        Isa::store(lanes, result);
+
+        for (const double lane : lanes)
+            if (! sameBits(lane, lanes[0]))
+                return std::nan("");
+
+        return lanes[0];
+    }
+
+    struct SharcCase
+    {
+        bool extended, multiply;
+        double a, b, expected;
+    };
+
+    // Worked by hand: ties either way, just off halfway, results the
+    // double operation alone would round onto a tie, flush and overflow
+    constexpr SharcCase sharcCases[] = {
+        { false, false, 1.0, 0x1p-24, 1.0 },                                 // tie, down to even
+        { false, false, 1.0 + 0x1p-23, 0x1p-24, 1.0 + 0x1p-22 },             // tie, up to even
+        { false, false, -1.0, -0x1p-24, -1.0 },
+        { false, false, 1.0, 0x1p-24 + 0x1p-40, 1.0 + 0x1p-23 },             // just past halfway
+        { false, false, 1.0, 0x1p-24 - 0x1p-45, 1.0 },                       // just short of it
+        { false, true, 1.0 + 0x1p-12, 1.0 + 0x1p-12, 1.0 + 0x1p-11 },        // tie
+        { false, true, 1.0 + 0x1p-12, 1.0 + 0x1p-12 + 0x1p-23, 1.0 + 0x1p-11 + 0x1p-22 },
+        { false, false, 0x1.8p-126, -0x1p-126, 0.0 },                        // 2^-127 flushed
+        { false, true, 0x1p-63, 0x1p-64, 0.0 },
+        { false, true, 0x1p-63, 0x1p-63, 0x1p-126 },                         // smallest normal kept
+        { false, true, 0x1p100, 0x1p100, HUGE_VAL },
+        { false, true, -0x1p100, 0x1p100, -HUGE_VAL },
+        { false, false, 0x1.fffffep127, 0x1p103, HUGE_VAL },                 // rounds past the top
+        { false, false, 0x1.fffffep127, 0x1p102, 0x1.fffffep127 },
+
+        { true, false, 1.0, 0x1p-32, 1.0 },                                  // tie, down to even
+        { true, false, 1.0 + 0x1p-31, 0x1p-32, 1.0 + 0x1p-30 },              // tie, up to even
+        { true, false, 1.0, 0x1p-32 + 0x1p-80, 1.0 + 0x1p-31 },              // double sum lands on the tie
+        { true, false, 1.0, 0x1p-32 - 0x1p-80, 1.0 },
+        { true, true, 1.0 + 0x1p-16, 1.0 + 0x1p-16, 1.0 + 0x1p-15 },         // tie
+        { true, true, 1.0 + 0x1p-35, 1.0 + 0x1p-32 - 0x1p-35, 1.0 + 0x1p-31 }, // double product lands on the tie
+        { true, false, 0x1.8p-126, -0x1p-126, 0.0 },
+        { true, true, 0x1p-63, 0x1p-64, 0.0 },
+        { true, true, 0x1p100, -0x1p100, -HUGE_VAL },
+        { true, false, 0x1.fffffffep127, 0x1p95, HUGE_VAL },
+        { true, false, 0x1.fffffffep127, 0x1p94, 0x1.fffffffep127 }
+    };
+
+    // Number of results off by even one bit: the worked cases, then 32-bit
+    // adds and multiplies of random floats against the FPU's own single
+    // rounding, flushed (near exponents for the adds, so ties turn up)
+    template <typename Isa>
+    int checkSharcArithmetic()
+    {
+        int wrong = 0;
+
+        for (const auto& c : sharcCases)
+        {
+            const double result = c.extended ? sharcOp<Isa, true>(c.multiply, c.a, c.b)
+                                             : sharcOp<Isa, false>(c.multiply, c.a, c.b);
+            wrong += sameBits(result, c.expected) ? 0 : 1;
+        }
+
+        std::minstd_rand rng(0x5a4c);
+        auto randomFloat = [&](uint32_t exponent)
+        {
+            const uint32_t bits = (static_cast<uint32_t>(rng() & 1) << 31) | (exponent << 23)
+                                | (static_cast<uint32_t>(rng()) & 0x7fffff);
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        };
+
+        for (int i = 0; i < 200000; ++i)
+        {
+            const auto exponent = static_cast<uint32_t>(1 + rng() % 254);
+            const auto near = static_cast<uint32_t>(std::clamp<int>(static_cast<int>(exponent) + static_cast<int>(rng() % 51) - 25, 1, 254));
+            const float a = randomFloat(exponent);
+            const float b = randomFloat(i % 2 == 0 ? near : static_cast<uint32_t>(1 + rng() % 254));
+
+            const float sum = a + b;
+            const float product = a * b;
+            auto flushed = [](float v) { return std::abs(v) < 0x1p-126f ? 0.0f : v; };
+
+            wrong += sameBits(sharcOp<Isa, false>(false, a, b), flushed(sum)) ? 0 : 1;
+            wrong += sameBits(sharcOp<Isa, false>(true, a, b), flushed(product)) ? 0 : 1;
+        }
+
+        return wrong;
+    }
+
+    //==============================================================================
+    // Two C API instances set up alike, one of them then sent NaN and
+    // infinity for every parameter; both must still render the same
+    double checkNonFiniteParams(const std::vector<std::vector<float>>& input)
+    {
+        const float junk[] = { std::nanf(""), HUGE_VALF, -HUGE_VALF };
+        const int numParams = DDX_RINGMOD_EMULATION + 1;
+        const int numCarrierParams = DDX_RINGMOD_CARRIER_LEVEL + 1;
+
+        std::vector<std::vector<float>> outputs[2] = { input, input };
+
+        for (int instance = 0; instance < 2; ++instance)
+        {
+            auto* ringmod = ddx_ringmod_create();
+            ddx_ringmod_prepare(ringmod, sampleRate, 512, numChannels, 0);
+            ddx_ringmod_set_param(ringmod, DDX_RINGMOD_AUDIO_RANGE, 1.0f);
+            ddx_ringmod_set_param(ringmod, DDX_RINGMOD_RATE, 0.4f);
+            ddx_ringmod_set_param(ringmod, DDX_RINGMOD_CARRIERS, 3.0f);
+            ddx_ringmod_set_param(ringmod, DDX_RINGMOD_DYNAMICS, 1.0f);
+
+            if (instance == 1)
+            {
+                for (const float value : junk)
+                {
+                    for (int param = 0; param < numParams; ++param)
+                        ddx_ringmod_set_param(ringmod, static_cast<DdxRingModParam>(param), value);
+
+                    for (int carrier = 2; carrier <= CarrierBank::maxCarriers; ++carrier)
+                        for (int param = 0; param < numCarrierParams; ++param)
+                            ddx_ringmod_set_carrier_param(ringmod, carrier, static_cast<DdxRingModCarrierParam>(param),
+                                                          value);
+                }
+            }
+
+            float* channels[numChannels];
+            for (int ch = 0; ch < numChannels; ++ch)
+                channels[ch] = outputs[instance][static_cast<size_t>(ch)].data();
+
+            ddx_ringmod_process_planar(ringmod, channels, nullptr, renderLength, nullptr, 0);
+            ddx_ringmod_destroy(ringmod);
+        }
+
+        return maxDifference(outputs[0], outputs[1]);
+    }
+
+    // The same for a voice batch: voice 1 gets the junk, voice 0 doesn't
+    double checkNonFiniteBatchParams(const std::vector<std::vector<float>>& input)
+    {
+        const float junk[] = { std::nanf(""), HUGE_VALF, -HUGE_VALF };
+        const int numParams = DDX_RINGMOD_EMULATION + 1;
+        const int numVoices = 2;
+
+        std::vector<std::vector<float>> outputs[numVoices] = { input, input };
+
+        auto* batch = ddx_ringmod_batch_create();
+        ddx_ringmod_batch_prepare(batch, sampleRate, numVoices, numChannels);
+
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            ddx_ringmod_batch_set_param(batch, voice, DDX_RINGMOD_AUDIO_RANGE, 1.0f);
+            ddx_ringmod_batch_set_param(batch, voice, DDX_RINGMOD_RATE, 0.4f);
+        }
+
+        for (const float value : junk)
+            for (int param = 0; param < numParams; ++param)
+                ddx_ringmod_batch_set_param(batch, 1, static_cast<DdxRingModParam>(param), value);
+
+        float* channels[numVoices * numChannels];
+        for (int voice = 0; voice < numVoices; ++voice)
+            for (int ch = 0; ch < numChannels; ++ch)
+                channels[voice * numChannels + ch] = outputs[voice][static_cast<size_t>(ch)].data();
+
+        ddx_ringmod_batch_process(batch, channels, numVoices, renderLength);
+        ddx_ringmod_batch_destroy(batch);
+
+        return maxDifference(outputs[0], outputs[1]);
+    }
+
+    //==============================================================================
+    // SHARC emulation, both precisions: a blend and rate change part way
+    // (ramped kernels), with dynamics (peak detection) and with spread
+    std::vector<CheckConfig> makeSharcConfigs()
+    {
+        std::vector<CheckConfig> configs;
+
+        for (const int emulation : { 1, 2 })
+        {
+            RingModSettings sharc;
+            sharc.audioRange = true;
+            sharc.rate = 0.4f;
+            sharc.blend = 0.7f;
+            sharc.emulation = emulation;
+
+            RingModSettings moved = sharc;
+            moved.rate = 0.6f;
+            moved.blend = 0.3f;
+
+            RingModSettings dynamics = sharc;
+            dynamics.dynamics = true;
+            dynamics.envToRate = 2.0f;
+
+            RingModSettings spread = sharc;
+            spread.spread = 0.25f;
+
+            const bool extended = emulation == 2;
+            configs.push_back({ extended ? "SHARC 40-bit" : "SHARC 32-bit", sharc, moved, commonBoundary });
+            configs.push_back({ extended ? "SHARC 40-bit, dynamics" : "SHARC 32-bit, dynamics", dynamics, dynamics,
+                                renderLength });
+            configs.push_back({ extended ? "SHARC 40-bit, spread" : "SHARC 32-bit, spread", spread, spread,
+                                renderLength });
+        }
+
+        return configs;
+    }
+
+    std::vector<CheckConfig> makeConfigs()
+    {
+        std::vector<CheckConfig> configs;
+
+        auto add = [&](const char* name, RingModSettings settings)
+        {
+            configs.push_back({ name, settings, settings, renderLength });
+        };
+
+        RingModSettings plain;
+        plain.audioRange = true;
+        plain.rate = 0.4f;
+        add("Scalar", plain);
+
+        RingModSettings simd = plain;
+        simd.simd = true;
+        add("SIMD", simd);
+
+        RingModSettings dynamics = plain;
+        dynamics.dynamics = true;
+        dynamics.envToRate = 2.0f;
+        dynamics.envToBlend = 0.8f;
+        add("Dynamics, scalar", dynamics);
+
+        RingModSettings dynamicsSimd = dynamics;
+        dynamicsSimd.simd = true;
+        add("Dynamics, SIMD", dynamicsSimd);
+
+        RingModSettings dynamicsLfo = dynamicsSimd;
+        dynamicsLfo.audioRange = false;
+        dynamicsLfo.envToBlend = -0.5f;
+        add("Dynamics, LFO range", dynamicsLfo);
+
+        RingModSettings dynamicsBank = dynamicsSimd;
+        dynamicsBank.numCarriers = 3;
+        add("Dynamics, 3 carriers", dynamicsBank);
+
+        RingModSettings dynamicsOversampled = dynamicsSimd;
+        dynamicsOversampled.oversamplingStages = 1;
+        add("Dynamics, 2x oversampling", dynamicsOversampled);
+
+        // Carrier mixed out (the envelope keeps listening), then faded in
+        RingModSettings mixedOut = dynamicsSimd;
+        mixedOut.blend = 0.0f;
+        configs.push_back({ "Dynamics, mixed out then in", mixedOut, dynamicsSimd, commonBoundary });
+
+        RingModSettings mixedOutOversampled = dynamicsOversampled;
+        mixedOutOversampled.blend = 0.0f;
+        configs.push_back({ "Dynamics, 2x, mixed out then in", mixedOutOversampled, dynamicsOversampled, commonBoundary });
+
+        return configs;
+    }
+}
+
+//==============================================================================
+int main()
+{
+    const auto input = makeInput();
+    const int blockSizes[] = { 1, 37, 64, 1024 };
+    bool passed = true;
+
+    for (const auto& config : makeConfigs())
+    {
+        // 512 is the reference; every other split must match it
+        const auto reference = render(config, input, 512);
+        double worst = 0.0;
+
+        for (const int blockSize : blockSizes)
+            worst = std::max(worst, maxDifference(reference, render(config, input, blockSize)));
+
+        const bool ok = worst <= tolerance;
+        passed = passed && ok;
+        std::printf("%-36s max difference %.3g  %s\n", config.name, worst, ok ? "ok" : "FAILED");
+    }
+
+    // A carrier mixed out still moves with the envelope: once faded back
+    // in (20ms), it matches one that was never mixed out
+    for (const int stages : { 0, 1 })
+    {
+        RingModSettings on;
+        on.audioRange = true;
+        on.rate = 0.4f;
+        on.simd = true;
+        on.dynamics = true;
+        on.envToRate = 2.0f;
+        on.envToBlend = 0.8f;
+        on.oversamplingStages = stages;
+
+        RingModSettings off = on;
+        off.blend = 0.0f;
+
+        const auto throughout = render({ "", on, on, renderLength }, input, 512);
+        const auto resumed = render({ "", off, on, commonBoundary }, input, 512);
+        const int settled = commonBoundary + static_cast<int>(sampleRate * 0.02) + 512;
+        double worst = 0.0;
+
+        for (size_t ch = 0; ch < throughout.size(); ++ch)
+            for (int i = settled; i < renderLength; ++i)
+                worst = std::max(worst, std::abs(static_cast<double>(throughout[ch][static_cast<size_t>(i)])
+                                                 - resumed[ch][static_cast<size_t>(i)]));
+
+        const bool ok = worst <= tolerance;
+        passed = passed && ok;
+        std::printf("%-36s max difference %.3g  %s\n", stages == 0 ? "Envelope while mixed out"
+                                                                  : "Envelope while mixed out, 2x",
+                    worst, ok ? "ok" : "FAILED");
+    }
+
+    // SHARC arithmetic, in one-lane tails and the native vector type
+    const std::pair<const char*, int> sharcArithmetic[] = {
+        { "SHARC arithmetic, scalar lanes", checkSharcArithmetic<SimdScalarDouble>() },
+        { "SHARC arithmetic, native lanes", checkSharcArithmetic<SimdNativeDouble>() }
+    };
+
+    for (const auto& [name, wrong] : sharcArithmetic)
+    {
+        passed = passed && wrong == 0;
+        std::printf("%-36s %d results wrong  %s\n", name, wrong, wrong == 0 ? "ok" : "FAILED");
+    }
+
+    // The emulation is defined bit for bit, so every instruction set this
+    // CPU runs must give the very same samples as the baseline kernels
+    const SimdLevel supported = getSupportedSimdLevel();
+
+    for (const auto& config : makeSharcConfigs())
+    {
+        const auto reference = render(config, input, 512, SimdLevel::Baseline);
+
+        for (const auto level : { SimdLevel::AVX2, SimdLevel::AVX512 })
+        {
+            const char* levelName = level == SimdLevel::AVX2 ? "AVX2" : "AVX-512";
+
+            if (level > supported)
+            {
+                std::printf("%-24s %-11s not supported here, skipped\n", config.name, levelName);
+                continue;
+            }
+
+            const double worst = maxDifference(reference, render(config, input, 512, level));
+            const bool ok = worst == 0.0;
+            passed = passed && ok;
+            std::printf("%-24s %-11s max difference %.3g  %s\n", config.name, levelName, worst, ok ? "ok" : "FAILED");
+        }
+    }
+
+    // Bad values from C callers are dropped, not clamped into the settings
+    const std::pair<const char*, double> nonFinite[] = {
+        { "C API, NaN and infinite params", checkNonFiniteParams(input) },
+        { "C API batch, NaN and infinite params", checkNonFiniteBatchParams(input) }
+    };
+
+    for (const auto& [name, worst] : nonFinite)
+    {
+        const bool ok = worst <= tolerance;
+        passed = passed && ok;
+        std::printf("%-36s max difference %.3g  %s\n", name, worst, ok ? "ok" : "FAILED");
+    }
+
+    std::printf("%s\n", passed ? "All checks passed" : "Some checks FAILED");
+    return passed ? 0 : 1;
+}
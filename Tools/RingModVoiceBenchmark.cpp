@@ -0,0 +1,368 @@
+/*
+  DDX3216 Ring Modulator Plugin - Voice Batch Benchmark
+  JUCE 8.0.11
+  Many tracks' worth of ring mods, run two ways: one DdxRingModAudioProcessor
+  per voice, each processBlock called through the AudioProcessor base as a
+  host calls it, against one RingModVoiceBatch processing every voice in a
+  single call. Voices get their own rates, blends and shapes (SIMD path on
+  the processors). Prints ns per voice-sample for both, the speedup and the
+  largest difference between their outputs as JSON.
+
+  Build as a JUCE console app (juce_audio_processors, juce_dsp) compiling
+  this file together with the plugin sources:
+  PluginProcessor.cpp, PluginEditor.cpp, RingModEngine.cpp, RingModVoiceBatch.cpp, RingModKernels*.cpp
+
+  Usage: RingModVoiceBenchmark [--quick] [--voices N] [--output results.json]
+*/
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+#include "../RingModVoiceBatch.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+
+namespace
+{
+    //==============================================================================
+    struct BenchCase
+    {
+        int numVoices = 200;
+        int channelsPerVoice = 2;       // mono or stereo tracks
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+        bool doublePrecision = false;
+    };
+
+    struct BenchResult
+    {
+        BenchCase config;
+        juce::Array<double> instanceNs, batchNs;    // per voice-sample, one entry per repetition
+        double instanceHarnessNs = 0.0;             // input refill costs, subtracted out
+        double batchHarnessNs = 0.0;
+        double maxDifference = 0.0;                 // first block, batch against instances
+    };
+
+    struct Settings
+    {
+        int repetitions = 7;
+        int64_t voiceSamplesPerRepetition = 1 << 22;
+        int warmupBlocks = 16;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    //==============================================================================
+    // Voice v's settings, on the parameters' 0.01 steps so both sides agree
+    RingModVoiceSettings voiceSettings(int v)
+    {
+        RingModVoiceSettings settings;
+        settings.rate = static_cast<float>((v * 37) % 101) * 0.01f;
+        settings.blend = static_cast<float>(25 + (v * 13) % 76) * 0.01f;
+        settings.waveform = static_cast<DdsWaveform>(v % 3);
+        settings.audioRange = (v / 3) % 2 == 1;
+        return settings;
+    }
+
+    void setParameter(juce::AudioProcessorValueTreeState& apvts, const juce::String& id, float plainValue)
+    {
+        if (auto* param = apvts.getParameter(id))
+            param->setValueNotifyingHost(param->convertTo0to1(plainValue));
+    }
+
+    template <typename SampleType>
+    void fillNoise(juce::AudioBuffer<SampleType>& buffer, uint32_t seed)
+    {
+        std::minstd_rand rng(seed);
+        std::uniform_real_distribution<SampleType> dist(SampleType(-0.5), SampleType(0.5));
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, dist(rng));
+    }
+
+    // Each voice reads the shared noise from its own place in it
+    int sourceOffset(int64_t block, int voice, int sourceBlocks, int blockSize)
+    {
+        return static_cast<int>((block + voice * 7) % sourceBlocks) * blockSize;
+    }
+
+    //==============================================================================
+    // Fresh input is copied in before every block, as in RingModBenchmark;
+    // with no processors (or no batch) only the copying is timed.
+    template <typename SampleType>
+    double timeInstances(const std::vector<std::unique_ptr<DdxRingModAudioProcessor>>* processors,
+                         const juce::AudioBuffer<SampleType>& source,
+                         std::vector<juce::AudioBuffer<SampleType>>& work, juce::MidiBuffer& midi,
+                         int channelsPerVoice, int64_t numBlocks)
+    {
+        const int numVoices = static_cast<int>(work.size());
+        const int blockSize = work.front().getNumSamples();
+        const int sourceBlocks = source.getNumSamples() / blockSize;
+
+        const auto start = Clock::now();
+
+        for (int64_t b = 0; b < numBlocks; ++b)
+        {
+            for (int v = 0; v < numVoices; ++v)
+            {
+                auto& buffer = work[static_cast<size_t>(v)];
+                const int offset = sourceOffset(b, v, sourceBlocks, blockSize);
+
+                for (int ch = 0; ch < channelsPerVoice; ++ch)
+                    buffer.copyFrom(ch, 0, source, ch, offset, blockSize);
+
+                if (processors != nullptr)
+                {
+                    juce::AudioProcessor& processor = *(*processors)[static_cast<size_t>(v)];
+                    processor.processBlock(buffer, midi);
+                }
+            }
+        }
+
+        const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        return elapsed / static_cast<double>(numBlocks * blockSize * numVoices);
+    }
+
+    template <typename SampleType>
+    double timeBatch(RingModVoiceBatch* batch, const juce::AudioBuffer<SampleType>& source,
+                     juce::AudioBuffer<SampleType>& work, int numVoices, int channelsPerVoice, int64_t numBlocks)
+    {
+        const int blockSize = work.getNumSamples();
+        const int sourceBlocks = source.getNumSamples() / blockSize;
+
+        const auto start = Clock::now();
+
+        for (int64_t b = 0; b < numBlocks; ++b)
+        {
+            for (int v = 0; v < numVoices; ++v)
+                for (int ch = 0; ch < channelsPerVoice; ++ch)
+                    work.copyFrom(v * channelsPerVoice + ch, 0, source, ch,
+                                  sourceOffset(b, v, sourceBlocks, blockSize), blockSize);
+
+            if (batch != nullptr)
+            {
+                // The host's audio callback would set this up once for all of them
+                juce::ScopedNoDenormals noDenormals;
+                batch->process(work.getArrayOfWritePointers(), numVoices, blockSize);
+            }
+        }
+
+        const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        return elapsed / static_cast<double>(numBlocks * blockSize * numVoices);
+    }
+
+    template <typename SampleType>
+    BenchResult runCase(const BenchCase& config, const Settings& settings)
+    {
+        BenchResult result;
+        result.config = config;
+
+        const int numVoices = config.numVoices;
+        const int channelsPerVoice = config.channelsPerVoice;
+        const auto trackLayout = channelsPerVoice == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+
+        // One processor per track
+        std::vector<std::unique_ptr<DdxRingModAudioProcessor>> processors;
+        std::vector<juce::AudioBuffer<SampleType>> instanceWork;
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            auto processor = std::make_unique<DdxRingModAudioProcessor>();
+            processor->setProcessingPrecision(config.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                     : juce::AudioProcessor::singlePrecision);
+
+            auto layout = processor->getBusesLayout();
+            layout.inputBuses.getReference(0) = trackLayout;
+            layout.outputBuses.getReference(0) = trackLayout;
+            processor->setBusesLayout(layout);
+
+            const auto voice = voiceSettings(v);
+            auto& apvts = processor->getAPVTS();
+            setParameter(apvts, "rate", voice.rate);
+            setParameter(apvts, "blend", voice.blend);
+            setParameter(apvts, "waveform", static_cast<float>(voice.waveform));
+            setParameter(apvts, "range", voice.audioRange ? 1.0f : 0.0f);
+            setParameter(apvts, "bypass", 0.0f);
+            setParameter(apvts, "simd", 1.0f);
+
+            processor->setRateAndBufferSizeDetails(config.sampleRate, config.blockSize);
+            processor->prepareToPlay(config.sampleRate, config.blockSize);
+
+            const int numChannels = juce::jmax(processor->getTotalNumInputChannels(),
+                                               processor->getTotalNumOutputChannels());
+            instanceWork.emplace_back(numChannels, config.blockSize);
+            instanceWork.back().clear();
+            processors.push_back(std::move(processor));
+        }
+
+        // One batch for all of them
+        RingModVoiceBatch batch;
+        batch.prepare(config.sampleRate, numVoices, channelsPerVoice);
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            batch.setVoice(v, voiceSettings(v));
+            batch.resetVoice(v);
+        }
+
+        juce::AudioBuffer<SampleType> batchWork(numVoices * channelsPerVoice, config.blockSize);
+
+        // A second of noise, cycled through block by block
+        const int sourceBlocks = juce::jmax(1, static_cast<int>(config.sampleRate) / config.blockSize);
+        juce::AudioBuffer<SampleType> source(channelsPerVoice, sourceBlocks * config.blockSize);
+        juce::MidiBuffer midi;
+        fillNoise(source, 0x5eed);
+
+        // Both start from prepare on the same input: compare the first block
+        timeInstances(&processors, source, instanceWork, midi, channelsPerVoice, 1);
+        timeBatch(&batch, source, batchWork, numVoices, channelsPerVoice, 1);
+
+        for (int v = 0; v < numVoices; ++v)
+            for (int ch = 0; ch < channelsPerVoice; ++ch)
+                for (int i = 0; i < config.blockSize; ++i)
+                    result.maxDifference = juce::jmax(result.maxDifference,
+                        std::abs(static_cast<double>(instanceWork[static_cast<size_t>(v)].getSample(ch, i)
+                                                     - batchWork.getSample(v * channelsPerVoice + ch, i))));
+
+        timeInstances(&processors, source, instanceWork, midi, channelsPerVoice, settings.warmupBlocks);
+        timeBatch(&batch, source, batchWork, numVoices, channelsPerVoice, settings.warmupBlocks);
+
+        const int64_t numBlocks = juce::jmax<int64_t>(1, settings.voiceSamplesPerRepetition
+                                                             / (static_cast<int64_t>(numVoices) * config.blockSize));
+
+        result.instanceHarnessNs = timeInstances<SampleType>(nullptr, source, instanceWork, midi, channelsPerVoice, numBlocks);
+        result.batchHarnessNs = timeBatch<SampleType>(nullptr, source, batchWork, numVoices, channelsPerVoice, numBlocks);
+
+        // Interleaved so drift in clock speed hits both alike
+        for (int rep = 0; rep < settings.repetitions; ++rep)
+        {
+            const double instanceNs = timeInstances(&processors, source, instanceWork, midi, channelsPerVoice, numBlocks);
+            const double batchNs = timeBatch(&batch, source, batchWork, numVoices, channelsPerVoice, numBlocks);
+            result.instanceNs.add(juce::jmax(0.0, instanceNs - result.instanceHarnessNs));
+            result.batchNs.add(juce::jmax(0.0, batchNs - result.batchHarnessNs));
+        }
+
+        for (auto& processor : processors)
+            processor->releaseResources();
+
+        return result;
+    }
+
+    //==============================================================================
+    double median(juce::Array<double> values)
+    {
+        values.sort();
+        return values[values.size() / 2];
+    }
+
+    double minimum(const juce::Array<double>& values)
+    {
+        double result = values.getFirst();
+        for (auto v : values)
+            result = juce::jmin(result, v);
+        return result;
+    }
+
+    juce::var toJson(const BenchResult& result)
+    {
+        const double instanceMedian = median(result.instanceNs);
+        const double batchMedian = median(result.batchNs);
+
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty("voices", result.config.numVoices);
+        obj->setProperty("channelsPerVoice", result.config.channelsPerVoice);
+        obj->setProperty("blockSize", result.config.blockSize);
+        obj->setProperty("sampleRate", result.config.sampleRate);
+        obj->setProperty("precision", result.config.doublePrecision ? "double" : "float");
+        obj->setProperty("instancesNsPerVoiceSampleMedian", instanceMedian);
+        obj->setProperty("instancesNsPerVoiceSampleMin", minimum(result.instanceNs));
+        obj->setProperty("batchNsPerVoiceSampleMedian", batchMedian);
+        obj->setProperty("batchNsPerVoiceSampleMin", minimum(result.batchNs));
+        obj->setProperty("speedup", batchMedian > 0.0 ? instanceMedian / batchMedian : 0.0);
+        obj->setProperty("maxDifference", result.maxDifference);
+        obj->setProperty("instancesHarnessNsPerVoiceSample", result.instanceHarnessNs);
+        obj->setProperty("batchHarnessNsPerVoiceSample", result.batchHarnessNs);
+        return juce::var(obj);
+    }
+
+    juce::var describeMachine()
+    {
+        RingModVoiceBatch batch;
+
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty("cpu", juce::SystemStats::getCpuModel());
+        obj->setProperty("numCpus", juce::SystemStats::getNumCpus());
+        obj->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        obj->setProperty("simdKernel", getSimdLevelName(batch.getSimdLevel()));
+        obj->setProperty("juceVersion", juce::SystemStats::getJUCEVersion());
+        return juce::var(obj);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    const bool quick = args.contains("--quick");
+    const int outputIndex = args.indexOf("--output");
+    const juce::File outputFile = outputIndex >= 0 && outputIndex + 1 < args.size()
+                                    ? juce::File::getCurrentWorkingDirectory().getChildFile(args[outputIndex + 1])
+                                    : juce::File();
+    const int voicesIndex = args.indexOf("--voices");
+    const int voices = voicesIndex >= 0 && voicesIndex + 1 < args.size()
+                         ? juce::jmax(1, args[voicesIndex + 1].getIntValue())
+                         : 0;
+
+    Settings settings;
+    if (quick)
+    {
+        settings.repetitions = 5;
+        settings.voiceSamplesPerRepetition = 1 << 20;
+    }
+
+    const juce::Array<int> voiceCounts = voices > 0 ? juce::Array<int>{ voices }
+                                       : quick ? juce::Array<int>{ 8, 200 }
+                                               : juce::Array<int>{ 1, 8, 64, 200 };
+    const juce::Array<int> blockSizes = quick ? juce::Array<int>{ 32, 512 }
+                                              : juce::Array<int>{ 16, 32, 64, 128, 256, 512, 1024 };
+
+    juce::Array<juce::var> results;
+
+    for (auto numVoices : voiceCounts)
+        for (auto blockSize : blockSizes)
+            for (int channelsPerVoice : { 1, 2 })
+                for (bool doublePrecision : { false, true })
+                {
+                    BenchCase config;
+                    config.numVoices = numVoices;
+                    config.channelsPerVoice = channelsPerVoice;
+                    config.blockSize = blockSize;
+                    config.doublePrecision = doublePrecision;
+
+                    results.add(toJson(doublePrecision ? runCase<double>(config, settings)
+                                                       : runCase<float>(config, settings)));
+                }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("benchmark", "RingModVoiceBatch::process vs DdxRingModAudioProcessor::processBlock per voice");
+    report->setProperty("machine", describeMachine());
+    report->setProperty("repetitions", settings.repetitions);
+    report->setProperty("voiceSamplesPerRepetition", static_cast<juce::int64>(settings.voiceSamplesPerRepetition));
+    report->setProperty("results", results);
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (outputFile != juce::File())
+        return outputFile.replaceWithText(json) ? 0 : 1;
+
+    std::cout << json << std::endl;
+    return 0;
+}